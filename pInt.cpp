@@ -15,9 +15,12 @@ If this is what you want to do, use the GNU Library General Public License inste
 //
 
 #include <iostream>
+#include <vector>
 
 #include "pIntClass.h"
 #include "pIntClassUtil.h"
+#include "pIntClassModular.h"
+#include "pIntClassRns.h"
 
 
 #ifdef PERF
@@ -64,6 +67,717 @@ void test13QuotientReminder()
 }
 
 
+/*
+*   NEWTONLIMIT and SSLIMIT are far above the sizes the tests can afford, the hook calls
+*   Newton division and the FFT product directly so they are tested whatever the limits.
+*/
+class pIntTest {
+public:
+    static void NewtonDivide(const pIntClass& A, const pIntClass& M, pIntClass& Q, pIntClass& R) { pIntClass::NewtonDivide(A, M, Q, R); }
+#ifdef SSLIMIT
+    /* r += sign * a * b, false if there is no FFT length for the product */
+    static bool FFTAccumulate(pIntClass& r, const pIntClass& a, const pIntClass& b, int sign) {
+        if (!r.SchoenhageStrassenAccumulate(a, b, sign, false)) return false;
+        r.normalize(r.value);
+        return true;
+    }
+    /* r = a * b */
+    static bool FFTMultiply(pIntClass& r, const pIntClass& a, const pIntClass& b) { return r.SchoenhageStrassenAccumulate(a, b, 1, true); }
+#endif
+};
+
+/* Newton reciprocal division, quotients shorter than the divisor (one step) and longer (in blocks) */
+void testNewtonQuotientReminder()
+{
+    int errors = 0;
+
+    for (int n : { NEWTONBASE + 1, 50, 400, 1500 })
+    {
+        pIntClass m = exponentiation(3, 19 * n);           // n limbs, 9.06 digits per limb
+        pIntClass num1 = exponentiation(7, 16 * n);        // 1.5 times as long
+        pIntClass num2 = exponentiation(7, 40 * n);        // more than twice as long, divided in blocks
+        for (int i = 0; i < 4; i++)
+        {
+            pIntClass a = (i < 2) ? num1 : num2;
+            pIntClass d = m;
+            d += 1000003 * i;
+            if (i & 1) a -= 1;
+            pIntClass Quotient;
+            pIntClass Remainder;
+            pIntTest::NewtonDivide(a, d, Quotient, Remainder);
+            pIntClass check = Remainder;
+            check.AddMul(Quotient, d);
+            if ((check != a) || Remainder.IsNeg() || !(Remainder < d)) errors++;
+        }
+    }
+    std::cout << "Newton division errors: " << errors << std::endl;
+}
+
+#ifdef SSLIMIT
+/* the FFT product and accumulation against Karatsuba / schoolbook, both signs */
+void testFFTMultiplication()
+{
+    int errors = 0;
+
+    for (int n : { 1, 39, 300, 3000 })
+        for (int i = 0; i < 4; i++)
+        {
+            pIntClass a = exponentiation(3, 19 * n + i);
+            pIntClass b = exponentiation(7, 10 * n + 3 * i);
+            if (i & 1) a.ChSignBit();
+            if (i & 2) b.ChSignBit();
+            pIntClass expected = a * b;
+
+            pIntClass r;
+            if (!pIntTest::FFTMultiply(r, a, b) || r != expected) errors++;
+
+            pIntClass c = exponentiation(11, 5 * n);
+            pIntClass sum = c;
+            int sign = (i & 1) ? -1 : 1;
+            if (!pIntTest::FFTAccumulate(sum, a, b, sign)) errors++;
+            pIntClass check = c;
+            if (sign > 0) check.AddMul(a, b);
+            else check -= expected;
+            if (sum != check) errors++;
+        }
+    std::cout << "FFT multiplication errors: " << errors << std::endl;
+}
+#endif
+
+/* Algorithm D, divisors from 2 to 70 limbs with digits which make the quotient estimates hard */
+void testKnuthQuotientReminder()
+{
+    int errors = 0;
+
+    for (int n = 2; n <= 70; n++)
+    {
+        for (int i = 0; i < 4; i++) {
+            std::string d = (i & 1) ? std::string(9 * n, '9') : "1" + std::string(9 * n - 1, '0');
+            if (i & 2) d[d.size() / 2] = '5';
+            pIntClass m(d);
+            pIntClass a = m;
+            a *= m;
+            a -= i + 1;
+            if (n & 1) a.ChSignBit();
+            if (i == 3) m.ChSignBit();
+            pIntClass Quotient;
+            pIntClass Remainder = RemQuotient(a, m, &Quotient);
+            pIntClass check = Remainder;
+            check.AddMul(Quotient, m);
+            if ((check != a) || Remainder.IsNeg() || !m.IsBiggerNummerically(Remainder)) errors++;
+        }
+    }
+    std::cout << "Algorithm D errors: " << errors << std::endl;
+}
+
+/* Burnikel-Ziegler division, divisors from 2 * BZLIMIT limbs, which are padded to j * 2^k limbs */
+void testBurnikelZieglerQuotientReminder()
+{
+    int sizes[] = { 2 * BZLIMIT, 2 * BZLIMIT + 1, 3 * BZLIMIT - 7, 5 * BZLIMIT + 3, 8 * BZLIMIT };
+    pIntClass x = exponentiation(7, 100 * BZLIMIT);    // 84 digits per BZLIMIT
+    int errors = 0;
+
+    for (int n : sizes)
+    {
+        for (int i = 0; i < 4; i++) {
+            std::string d = (i & 1) ? std::string(9 * n, '9') : "1" + std::string(9 * n - 1, '0');
+            if (i & 2) d[d.size() / 3] = '5';
+            pIntClass m(d);
+            pIntClass a = (i < 2) ? m : x;
+            a *= (i < 2) ? m : x;
+            a -= i + 1;
+            if (n & 1) a.ChSignBit();
+            if (i == 3) m.ChSignBit();
+            pIntClass Quotient;
+            pIntClass Remainder = RemQuotient(a, m, &Quotient);
+            pIntClass check = Remainder;
+            check.AddMul(Quotient, m);
+            if ((check != a) || Remainder.IsNeg() || !m.IsBiggerNummerically(Remainder)) errors++;
+        }
+    }
+    std::cout << "Burnikel-Ziegler errors: " << errors << std::endl;
+}
+
+
+/* DivModInt, ModInt and ModInts against RemQuotient */
+void testDivModInt()
+{
+    uint32_t divisors[] = { 1, 2, 3, 7, 10, 999999999, 1000000000, 1000000007, 2147483647, 4294967291u, 4294967295u };
+    const size_t count = sizeof(divisors) / sizeof(divisors[0]);
+    pIntDivisor precomputed[count];
+    for (size_t j = 0; j < count; j++) precomputed[j] = pIntDivisor(divisors[j]);
+    pIntClass x = exponentiation(3, 500);
+    int errors = 0;
+
+    for (int i = 0; i < 40; i++)
+    {
+        pIntClass a = x;
+        if (i & 1) a.ChSignBit();
+        a += i * 1234567;
+        if (i == 38) a = 0;
+        if (i == 39) a = -5;
+
+        uint32_t remainders[count];
+        a.ModInts(precomputed, count, remainders);
+        for (size_t j = 0; j < count; j++) {
+            pIntClass Quotient;
+            pIntClass Remainder = RemQuotient(a, pIntClass(std::to_string(divisors[j])), &Quotient);
+
+            pIntClass q = a;
+            uint32_t r = q.DivModInt(divisors[j]);
+            if ((q != Quotient) || (pIntClass(std::to_string(r)) != Remainder)) errors++;
+            pIntClass q1 = a;
+            if ((q1.DivModInt(precomputed[j]) != r) || (q1 != q)) errors++;
+            if ((a.ModInt(divisors[j]) != r) || (remainders[j] != r)) errors++;
+        }
+    }
+    std::cout << "DivModInt errors: " << errors << std::endl;
+}
+
+
+/* Montgomery products and powers against modmult, both sides of MONTGOMERYLIMIT */
+void testMontgomery()
+{
+    int errors = 0;
+    size_t sizes[] = { 1, 2, 5, MONTGOMERYLIMIT - 1, MONTGOMERYLIMIT, 2 * MONTGOMERYLIMIT + 3 };
+
+    for (size_t limbs : sizes)
+    {
+        pIntClass m = exponentiation(7, (int)(9 * limbs));
+        while ((size_t)m.Size() > limbs) m.ShiftLimbsRight(1);
+        m -= (int)m.ModInt(10);
+        m += 3;
+        MontgomeryContext ctx(m);
+
+        pIntClass a = exponentiation(3, (int)(19 * limbs + 7));
+        pIntClass b = exponentiation(11, (int)(8 * limbs + 1));
+        b.ChSignBit();
+        pIntClass am = ctx.ToMontgomery(a), bm = ctx.ToMontgomery(b);
+        if (ctx.FromMontgomery(ctx.Multiply(am, bm)) != modmult(a, b, m)) errors++;
+        if (ctx.FromMontgomery(ctx.Square(am)) != modmult(a, a, m)) errors++;
+
+        pIntClass p = 1;
+        for (int e = 0; e < 40; e++) {
+            if (ctx.Pow(a, pIntClass(e)) != RemQuotient(p, m, NULL)) errors++;
+            p = modmult(p, a, m);
+        }
+    }
+
+    /* Fermat for the Mersenne prime 2^127 - 1 */
+    pIntClass p("170141183460469231731687303715884105727");
+    pIntClass p1 = p;
+    p1 -= 1;
+    if (!modpow(pIntClass(3), p1, p).IsOne()) errors++;
+    std::cout << "Montgomery errors: " << errors << std::endl;
+}
+
+
+/* Barrett reduction against RemQuotient, both sides of BARRETTLIMIT */
+void testBarrett()
+{
+    int errors = 0;
+    size_t sizes[] = { 1, 2, 7, BARRETTLIMIT - 1, BARRETTLIMIT + 5 };
+
+    for (size_t limbs : sizes)
+    {
+        pIntClass m = exponentiation(2, (int)(30 * limbs - 29));
+        m *= 5;
+        if (limbs == 2) m = 1000000000;
+        BarrettContext ctx(m);
+
+        pIntClass a = exponentiation(3, (int)(19 * limbs + 7));
+        pIntClass b = exponentiation(7, (int)(11 * limbs + 1));
+        pIntClass x = a * b;
+        for (int i = 0; i < 20; i++) {
+            if (ctx.Reduce(x) != RemQuotient(x, m, NULL)) errors++;
+            if (ctx.Multiply(a, b) != modmult(a, b, m)) errors++;
+            x += m * i;
+            a += 1000003 * i;
+        }
+        x.ChSignBit();
+        if (ctx.Reduce(x) != RemQuotient(x, m, NULL)) errors++;
+        if (!ctx.Reduce(m * m).IsZero()) errors++;
+    }
+    std::cout << "Barrett errors: " << errors << std::endl;
+}
+
+
+/* a^(x+y) = a^x * a^y for every window size, moduli with and without the factors 2 and 5 */
+void testModPow()
+{
+    int errors = 0;
+    const char* moduli[] = { "1", "10", "1000000007", "170141183460469231731687303715884105727",
+                             "340282366920938463463374607431768211456", "98765432109876543210987654321098765435" };
+
+    for (const char* ms : moduli)
+    {
+        pIntClass m(ms);
+        pIntClass a = exponentiation(3, 100);
+        a += 17;
+        for (int bits = 1; bits < 3000; bits = 3 * bits + 1) {
+            pIntClass x = exponentiation(2, bits);
+            x -= 1234567;
+            if (x.IsNeg()) x.ChSignBit();
+            pIntClass y = exponentiation(7, bits / 3 + 1);
+            pIntClass xy = x;
+            xy += y;
+            if (modpow(a, xy, m) != modmult(modpow(a, x, m), modpow(a, y, m), m)) errors++;
+        }
+        if (modpow(a, pIntClass(0), m) != RemQuotient(pIntClass(1), m, NULL)) errors++;
+    }
+    std::cout << "modpow errors: " << errors << std::endl;
+}
+
+
+/* comb exponentiation against modpow, exponents shorter and longer than the table */
+void testFixedBasePow()
+{
+    int errors = 0;
+    const char* moduli[] = { "1000000007", "340282366920938463463374607431768211456", "98765432109876543210987654321098765435" };
+
+    for (const char* ms : moduli)
+        for (size_t maxbits : { 20, 200, 1000, 3000 })
+        {
+            pIntClass m(ms);
+            pIntClass g = exponentiation(3, 50);
+            FixedBasePow fb(g, m, maxbits);
+            for (int bits = 0; bits < 4000; bits = 2 * bits + 7) {
+                pIntClass e = exponentiation(2, bits);
+                e -= 1;
+                e *= 5;
+                if (fb.Pow(e) != modpow(g, e, m)) errors++;
+            }
+            if (fb.Pow(pIntClass(0)) != RemQuotient(pIntClass(1), m, NULL)) errors++;
+        }
+    std::cout << "FixedBasePow errors: " << errors << std::endl;
+}
+
+
+/* a^x * b^y * c^z against separate modpow calls */
+void testMultiPow()
+{
+    int errors = 0;
+    const char* moduli[] = { "1", "1000000007", "340282366920938463463374607431768211456", "98765432109876543210987654321098765435" };
+
+    for (const char* ms : moduli)
+    {
+        pIntClass m(ms);
+        pIntClass bases[3] = { exponentiation(3, 60), exponentiation(5, 41), pIntClass(-7) };
+        for (int bits = 0; bits < 2000; bits = 3 * bits + 5) {
+            pIntClass exponents[3] = { exponentiation(2, bits), exponentiation(3, bits / 2), pIntClass(bits) };
+            exponents[0] -= 1;
+            pIntClass expected = RemQuotient(pIntClass(1), m, NULL);
+            for (int count = 0; count <= 3; count++) {
+                if (MultiPow(bases, exponents, count, m) != expected) errors++;
+                if (count < 3) expected = modmult(expected, modpow(bases[count], exponents[count], m), m);
+            }
+        }
+    }
+    std::cout << "MultiPow errors: " << errors << std::endl;
+}
+
+
+/* gcd(g * a, g * b) = g for coprime a, b, on both sides of GCDLIMIT, and the inverses modulo a prime */
+void testGcd()
+{
+    int errors = 0;
+
+    for (int digits = 5; digits < 20000; digits *= 3)
+    {
+        pIntClass a = exponentiation(2, digits * 10 / 3);
+        a += 1;
+        pIntClass b = exponentiation(3, digits * 2);
+        pIntClass g = exponentiation(5, digits / 2);
+        g *= 7;
+        pIntClass ga = g * a;
+        pIntClass gb = g * b;
+        gb.ChSignBit();
+
+        pIntClass x, y;
+        if (Gcd(ga, gb) != g) errors++;
+        if (ExtendedGcd(ga, gb, &x, &y) != g) errors++;
+        pIntClass t = ga * x + gb * y;
+        if (t != g) errors++;
+        if (Gcd(ga, 0) != ga || Gcd(0, 0) != 0 || Gcd(ga, ga) != ga) errors++;
+
+        pIntClass inv;
+        if (!ModInverse(b, a, inv)) errors++;
+        t = b * inv;
+        if (!RemQuotient(t, a, NULL).IsOne()) errors++;
+        if (ModInverse(ga, gb, inv)) errors++;
+    }
+
+    pIntClass p("170141183460469231731687303715884105727");
+    for (int i = 1; i < 100; i++) {
+        pIntClass inv;
+        ModInverse(pIntClass(i), p, inv);
+        if (!modmult(inv, pIntClass(i), p).IsOne()) errors++;
+    }
+    std::cout << "Gcd errors: " << errors << std::endl;
+}
+
+
+/* Euler's criterion for primes below and above JACOBILIMIT limbs, (a / mn) = (a / m)(a / n) */
+void testJacobi()
+{
+    int errors = 0;
+    const char* primes[] = { "1000000007", "170141183460469231731687303715884105727",
+                             "6864797660130609714981900799081393217269435300143305409394463459185543183397656052122559640661454554977296311391480858037121987999716643812574028291115057151" };
+
+    for (const char* ps : primes)
+    {
+        pIntClass p(ps);
+        pIntClass e = p;
+        e -= 1;
+        e >>= 1;
+        pIntClass a = exponentiation(3, 200);
+        for (int i = 0; i < 30; i++) {
+            a += 1000003 * i;
+            pIntClass t = modpow(a, e, p);
+            int expected = t.IsOne() ? 1 : (t.IsZero() ? 0 : -1);
+            if (Jacobi(a, p) != expected) errors++;
+            pIntClass na = a;
+            na.ChSignBit();
+            if (Jacobi(na, p) != expected * Jacobi(pIntClass(-1), p)) errors++;
+        }
+    }
+
+    pIntClass m = exponentiation(3, 301);
+    pIntClass n = exponentiation(7, 155);
+    n += 2;
+    pIntClass mn = m * n;
+    for (int i = 1; i < 40; i++) {
+        pIntClass a = exponentiation(11, 7 * i);
+        a += i;
+        if (Jacobi(a, mn) != Jacobi(a, m) * Jacobi(a, n)) errors++;
+    }
+    std::cout << "Jacobi errors: " << errors << std::endl;
+}
+
+
+/* 10^k - c and 10^k + c moduli against RemQuotient, and a binary form which is left to Barrett */
+void testModReducer()
+{
+    int errors = 0;
+    int detected = 0;
+
+    for (int k = 9 * SPECIALFORMLIMIT - 5; k < 1000; k = 2 * k + 1)
+        for (int c : { 1, 7, 123456789, 999999999 })
+            for (int form = 0; form < 2; form++)
+            {
+                pIntClass m(1);
+                m.MulPow10(k);
+                if (form == 0) m -= c;
+                else m += c;
+                ModReducer r(m);
+                if (r.GetForm() != (form ? ModReducer::DECIMALPLUS : ModReducer::DECIMALMINUS)) errors++;
+                else detected++;
+
+                pIntClass a = exponentiation(3, 3 * k);
+                pIntClass b = exponentiation(7, k);
+                b.ChSignBit();
+                pIntClass x = a * a;
+                if (r.Reduce(x) != RemQuotient(x, m, NULL)) errors++;
+                if (r.Reduce(b) != RemQuotient(b, m, NULL)) errors++;
+                if (r.Multiply(a, b) != RemQuotient(pIntClass(a * b), m, NULL)) errors++;
+                if (!r.Reduce(m).IsZero()) errors++;
+                pIntClass e = exponentiation(2, 100);
+                pIntClass e1 = e;
+                e1 += 1;
+                if (modpow(a, e1, m) != modmult(modpow(a, e, m), a, m)) errors++;
+            }
+
+    pIntClass mersenne = exponentiation(2, 521);
+    mersenne -= 1;
+    if (ModReducer(mersenne).GetForm() != ModReducer::GENERIC) errors++;
+    std::cout << "ModReducer errors: " << errors << " detected " << detected << std::endl;
+}
+
+
+/* batch inverses against ModInverse, on one and on several threads, with a value that has no inverse */
+void testBatchModInverse()
+{
+    int errors = 0;
+    pIntClass p("115792089237316195423570985008687907853269984665640564039457584007908834671663");
+    pIntClass m = p * 10;
+
+    for (int threads = 1; threads <= 4; threads *= 2)
+        for (size_t count : { 0, 1, 2, 300 })
+        {
+            std::vector<pIntClass> values(count), inverses(count);
+            for (size_t i = 0; i < count; i++) values[i] = exponentiation(3, 150 + (int)i) + (int)i;
+            if (!BatchModInverse(values.data(), count, p, inverses.data(), threads)) errors++;
+            for (size_t i = 0; i < count; i++)
+                if (!modmult(values[i], inverses[i], p).IsOne()) errors++;
+
+            if (count < 2) continue;
+            values[1] = 5;
+            if (BatchModInverse(values.data(), count, m, inverses.data(), threads)) errors++;
+            for (size_t i = 0; i < count; i++) {
+                pIntClass inv;
+                ModInverse(values[i], m, inv);
+                if (inv != inverses[i]) errors++;
+            }
+        }
+    std::cout << "BatchModInverse errors: " << errors << std::endl;
+}
+
+
+/* CrtContext::Pow against modpow modulo the product, for primes and for a prime power */
+void testCrt()
+{
+    int errors = 0;
+    pIntClass p("115792089237316195423570985008687907853269984665640564039457584007908834671663");
+    pIntClass q("26959946667150639794667015087019630673557916260026308143510066298881");
+    pIntClass r("170141183460469231731687303715884105727");
+
+    CrtContext two(p, q);
+    pIntClass factors[3] = { p, q, r };
+    CrtContext three(factors, 3);
+    pIntClass powers[2] = { p * p, q };
+    CrtContext power(powers, 2, false);
+
+    for (int threads = 1; threads <= 2; threads++)
+        for (int i = 0; i < 20; i++) {
+            pIntClass a = exponentiation(3, 200 + 37 * i);
+            a -= i;
+            if (i == 1) a = p * 5;
+            pIntClass e = exponentiation(7, 50 * i);
+            if (two.Pow(a, e, threads) != modpow(a, e, two.Modulus())) errors++;
+            if (three.Pow(a, e, threads) != modpow(a, e, three.Modulus())) errors++;
+            if (power.Pow(a, e, threads) != modpow(a, e, power.Modulus())) errors++;
+        }
+
+    /* Mersenne primes of 21 to 357 limbs, above CRTTHREADLIMIT so the factors are spread over the workers */
+    pIntClass mersenne[5];
+    int exponents[5] = { 607, 1279, 2203, 2281, 3217 };
+    for (int i = 0; i < 5; i++) mersenne[i] = exponentiation(2, exponents[i]) - 1;
+    CrtContext five(mersenne, 5);
+    for (int threads = 1; threads <= 4; threads++)
+        for (int i = 0; i < 3; i++) {
+            pIntClass a = exponentiation(3, 5000 + 101 * i);
+            pIntClass e = exponentiation(7, 20 + 13 * i);
+            if (five.Pow(a, e, threads) != modpow(a, e, five.Modulus())) errors++;
+        }
+
+    pIntClass residues[3] = { 1, 2, 3 };
+    pIntClass x = three.Combine(residues);
+    if (RemQuotient(x, p, NULL) != 1 || RemQuotient(x, q, NULL) != 2 || RemQuotient(x, r, NULL) != 3) errors++;
+    std::cout << "Crt errors: " << errors << std::endl;
+}
+
+/* HasSmallFactor against ModInt by every prime up to the bound, MillerRabin on small primes */
+void testSmallFactor()
+{
+    int errors = 0;
+    std::vector<uint32_t> primes;
+    for (uint32_t p = 2; p < 5000; p++) {
+        bool prime = true;
+        for (uint32_t d = 2; d * d <= p; d++)
+            if (p % d == 0) prime = false;
+        if (prime) primes.push_back(p);
+    }
+
+    for (int i = 0; i < 200; i++) {
+        pIntClass n = exponentiation(3, 20 + 7 * i);
+        n += 2 * i + 1;
+        for (uint32_t bound : { 2u, 30u, 1000u, 4999u }) {
+            uint32_t expected = 0, factor = 0;
+            for (uint32_t p : primes)
+                if (p <= bound && n.ModInt(p) == 0) {
+                    expected = p;
+                    break;
+                }
+            bool found = HasSmallFactor(n, bound, &factor);
+            if (found != (expected != 0) || (found && factor != expected)) errors++;
+        }
+    }
+
+    for (int p : { 3, 7, 4093, 4099, 65537 })
+        if (!MillerRabin(pIntClass(p), 10)) errors++;
+    for (int c : { 9, 4097, 196617 })
+        if (MillerRabin(pIntClass(c), 10)) errors++;
+    std::cout << "SmallFactor errors: " << errors << std::endl;
+}
+
+/* BailliePSW against trial division, on Mersenne numbers (2^p - 1 composite is a base 2 strong pseudoprime) and pseudoprimes */
+void testBPSW()
+{
+    int errors = 0;
+    for (int n = 0; n < 20000; n++) {
+        bool prime = n > 1;
+        for (int d = 2; d * d <= n; d++)
+            if (n % d == 0) prime = false;
+        if (BailliePSW(pIntClass(n)) != prime) errors++;
+    }
+
+    /* strong Lucas pseudoprimes, base 2 strong pseudoprimes and Carmichael numbers */
+    for (const char* c : { "5459", "5777", "10877", "2047", "3215031751", "561", "3825123056546413051", "318665857834031151167461" })
+        if (BailliePSW(pIntClass(c))) errors++;
+
+    for (int p : { 61, 67, 89, 101, 103, 107, 109, 127, 521, 607, 1279 }) {
+        pIntClass m = exponentiation(2, p);
+        m -= 1;
+        bool prime = (p != 67 && p != 101 && p != 103 && p != 109);
+        if (BailliePSW(m) != prime) errors++;
+    }
+
+    /* both sides of 2^64, the deterministic bases below and the Lucas test above */
+    for (const char* p : { "18446744073709551557", "18446744073709551629" })
+        if (!BailliePSW(pIntClass(p))) errors++;
+    for (const char* c : { "18446744073709551615", "18446744073709551617" })
+        if (BailliePSW(pIntClass(c))) errors++;
+    std::cout << "BPSW errors: " << errors << std::endl;
+}
+
+/* MillerRabin with the witnesses on threads: Mersenne primes pass, 2^607 - 1 times a prime fails */
+void testMRThreads()
+{
+    int errors = 0;
+    pIntClass composite = exponentiation(2, 607);
+    composite -= 1;
+    composite *= pIntClass("170141183460469231731687303715884105727");
+
+    for (int threads = 1; threads <= 4; threads++)
+        for (int p : { 521, 607 }) {
+            pIntClass m = exponentiation(2, p);
+            m -= 1;
+            if (!MillerRabin(m, 8, TRIALDIVISIONBOUND, threads)) errors++;
+            if (MillerRabin(composite, 8, TRIALDIVISIONBOUND, threads)) errors++;
+        }
+    std::cout << std::endl << "MRThreads errors: " << errors << std::endl;
+}
+
+/* FilterPrimes against BailliePSW one by one, the callback variant stops when asked to */
+void testFilterPrimes()
+{
+    int errors = 0;
+    std::vector<pIntClass> candidates;
+    for (int i = 0; i < 1000; i++) {
+        pIntClass c = exponentiation(10, 30 + i / 100);
+        c += i;
+        candidates.push_back(c);
+    }
+    std::vector<pIntClass> expected;
+    for (const pIntClass& c : candidates)
+        if (BailliePSW(c)) expected.push_back(c);
+
+    for (int threads = 1; threads <= 2; threads++) {
+        if (FilterPrimes(candidates.data(), candidates.size(), threads) != expected) errors++;
+
+        size_t calls = 0;
+        size_t found = FilterPrimes(candidates.data(), candidates.size(),
+            [&](size_t i, const pIntClass& p) { if (p != candidates[i] || p != expected[calls]) errors++; return ++calls < 5; }, threads);
+        if (found != 5 || calls != 5) errors++;
+    }
+    std::cout << "FilterPrimes errors: " << errors << std::endl;
+}
+
+/* run first in main: the worker threads of FilterPrimes initialize the shared tables (the primes above 2^64 reach IsPerfectSquare) */
+void testFilterPrimesFirst()
+{
+    int errors = 0;
+    std::vector<pIntClass> candidates;
+    for (int i = 0; i < 600; i++) {
+        pIntClass c = exponentiation(10, 40);
+        c += 2 * i + 1;
+        candidates.push_back(c);
+    }
+    std::vector<pIntClass> primes = FilterPrimes(candidates.data(), candidates.size(), 4);
+
+    std::vector<pIntClass> expected;
+    for (const pIntClass& c : candidates)
+        if (BailliePSW(c)) expected.push_back(c);
+    if (primes != expected || primes.empty()) errors++;
+    std::cout << "FilterPrimesFirst errors: " << errors << std::endl;
+}
+
+/* r = IRoot(n, k) must satisfy r^k <= n < (r + 1)^k, around exact powers and on random sizes */
+void testRoots()
+{
+    int errors = 0;
+
+    for (int k = 2; k < 40; k += (k < 5) ? 1 : 7)
+        for (int digits = 1; digits < 6000; digits = 3 * digits + 2)
+        {
+            pIntClass r = exponentiation(7, std::max(digits / k, 3));
+            r += 2;
+            pIntClass p(1);
+            for (int i = 0; i < k; i++) p *= r;
+
+            for (int d = -1; d <= 1; d++) {
+                pIntClass n = p;
+                n += d;
+                pIntClass expected = r;
+                if (d < 0) expected -= 1;
+                if (IRoot(n, k) != expected) errors++;
+                if ((k == 2) && (IsPerfectSquare(n) != (d == 0))) errors++;
+            }
+            pIntClass base;
+            int e;
+            if (!IsPerfectPower(p, &base, &e) || (e % k) != 0) errors++;
+            p *= 10;
+            p += 1;
+            if (IsPerfectPower(p)) errors++;
+        }
+
+    if (ISqrt(pIntClass(0)) != 0 || ISqrt(pIntClass(99)) != 9 || IRoot(pIntClass(-27), 3) != -3) errors++;
+    pIntClass a = exponentiation(6, 35);
+    pIntClass b;
+    int e;
+    if (!IsPerfectPower(a, &b, &e) || b != 6 || e != 35) errors++;
+    std::cout << "Roots errors: " << errors << std::endl;
+}
+
+
+/* products, sums of products and a polynomial (Horner) in residue form against pIntClass */
+void testRns()
+{
+    int errors = 0;
+
+    for (size_t limbs : { 4, 30, 64, 65, 200, 700 })
+    {
+        RnsContext ctx(limbs);
+        int digits = (int)limbs * 9 - 1;
+
+        pIntClass x = exponentiation(3, digits * 2);
+        x.DivPow10(std::max(x.Size() * 9 - digits, 0));
+        if (RnsNumber(ctx, x).Value() != x) errors++;
+        x.ChSignBit();
+        if (RnsNumber(ctx, x).Value() != x) errors++;
+
+        pIntClass product(1), sum(0);
+        RnsNumber rproduct(ctx, 1), rsum(ctx);
+        for (int i = 1; i <= 20; i++) {
+            pIntClass a = exponentiation(7, std::max(digits / 25, 1));
+            a += i;
+            if (i & 1) a.ChSignBit();
+            RnsNumber ra(ctx, a);
+            product *= a;
+            rproduct *= ra;
+            sum += a * a;
+            rsum += ra * ra;
+            sum -= i;
+            rsum -= RnsNumber(ctx, i);
+        }
+        if (rproduct.Value() != product || rsum.Value() != sum) errors++;
+
+        /* p(t) = sum (i + 1) t^i, i < 10, t^9 fits */
+        pIntClass t = exponentiation(5, std::max(digits / 8, 1));
+        RnsNumber rt(ctx, t);
+        pIntClass value(0);
+        RnsNumber rvalue(ctx);
+        for (int i = 9; i >= 0; i--) {
+            value *= t;
+            value += i + 1;
+            rvalue *= rt;
+            rvalue += RnsNumber(ctx, i + 1);
+        }
+        if (rvalue.Value() != value) errors++;
+    }
+    std::cout << "Rns errors: " << errors << std::endl;
+}
+
 void test15Jacobi()
 {
 
@@ -81,11 +795,147 @@ void test15Jacobi()
 
 void testSubtraction();
 void testAddition();
+void testExpressions();
 void testMultiplication();
 void testTonelliShanks();
 void testMR();
 void testModMult();
 
+/* AddMul/SubMul against the product computed with *= */
+void testAddMul()
+{
+    pIntClass a("-123456789012345678901234567890");
+    pIntClass b("987654321987654321");
+    pIntClass r("55555555555555555555555555555555555555");
+    int errors = 0;
+
+    for (int i = 0; i < 3; i++) {
+        pIntClass p = a;
+        p *= b;
+        pIntClass t = r;
+        t += p;
+        pIntClass s = r;
+        s.AddMul(a, b);
+        if (s != t) errors++;
+        t = r;
+        t -= p;
+        s = r;
+        s.SubMul(a, b);
+        if (s != t) errors++;
+
+        /* the int versions */
+        p = a;
+        p *= -777777777;
+        t = r;
+        t += p;
+        s = r;
+        s.AddMul(a, -777777777);
+        if (s != t) errors++;
+        s = r;
+        s.SubMul(a, 777777777);
+        if (s != t) errors++;
+
+        /* aliasing, r + r * r */
+        p = r;
+        p *= r;
+        t = r;
+        t += p;
+        s = r;
+        s.AddMul(s, s);
+        if (s != t) errors++;
+
+        /* a.size(), b.size() >= KARATSUBALIMIT goes through Karatsuba */
+        a = exponentiation(-3, 1001 + 1000 * i);
+        b = exponentiation(7, 1001 + 700 * i);
+    }
+    std::cout << "AddMul errors: " << errors << std::endl;
+}
+
+/* MulPow10, DivPow10 and DivPow10Rounded against the decimal strings */
+void testDecimalShift()
+{
+    std::string digits = "31415926535897932384626433832795028841971";  // 41 digits
+    int errors = 0;
+
+    for (int d = 0; d < 60; d++)
+    {
+        for (int sign = 1; sign >= -1; sign -= 2) {
+            std::string minus = (sign < 0) ? "-" : "";
+            pIntClass x(minus + digits);
+
+            pIntClass m = x;
+            m.MulPow10(d);
+            if (m.ToString() != minus + digits + std::string(d, '0')) errors++;
+
+            /* d > 41 shifts everything out, d % 9 == 0 only moves digits */
+            pIntClass q = x;
+            pIntClass r = q.DivPow10(d);
+            pIntClass check = r;
+            check.AddMul(q, exponentiation(10, d));
+            if (check != x) errors++;
+            if (d <= 41) {
+                std::string high = digits.substr(0, 41 - d);
+                if (d == 41) high = "0";
+                else high = minus + high;
+                if (q.ToString() != high) errors++;
+            }
+            else if (!q.IsZero() || (r != x)) errors++;
+
+            /* x * 10^d + 5 * 10^(d-1) is an exact tie, rounded away from 0 */
+            if (d > 0) {
+                pIntClass tie = m;
+                pIntClass half(5 * sign);
+                half.MulPow10(d - 1);
+                tie += half;
+                tie.DivPow10Rounded(d);
+                pIntClass up = x;
+                up += sign;
+                if (tie != up) errors++;
+                tie = m;
+                tie += half;
+                tie -= sign;          // just below the tie
+                tie.DivPow10Rounded(d);
+                if (tie != x) errors++;
+            }
+        }
+    }
+    std::cout << "DecimalShift errors: " << errors << std::endl;
+}
+
+/* MulPow2, DivPow2 and TrailingZeroBits against multiplication by exponentiation(2, k) */
+void testPow2()
+{
+    pIntClass x("-98765432109876543210987654321098765432101");   // odd
+    int errors = 0;
+
+    for (unsigned int k = 0; k < 200; k += 7)
+    {
+        pIntClass p2 = exponentiation(2, k);
+        for (int sign = 1; sign >= -1; sign -= 2) {
+            pIntClass y = x;
+            if (sign < 0) y.ChSignBit();
+            pIntClass t = y;
+            t *= p2;
+            pIntClass m = y;
+            m.MulPow2(k);
+            if (m != t) errors++;
+            if (m.TrailingZeroBits() != k) errors++;
+
+            /* y = q * 2^k + r, r has the sign of y and |r| < 2^k */
+            pIntClass q = y;
+            pIntClass r = q.DivPow2(k);
+            pIntClass check = r;
+            check.AddMul(q, p2);
+            if ((check != y) || (!r.IsZero() && (r.IsNeg() != y.IsNeg())) || !p2.IsBiggerNummerically(r)) errors++;
+
+            q = m;
+            r = q.DivPow2(k);
+            if ((q != y) || !r.IsZero()) errors++;
+        }
+    }
+    std::cout << "Pow2 errors: " << errors << std::endl;
+}
+
 void testpIntClass2(){
 
     pIntClass  a("4999999999999999999999999999");
@@ -183,6 +1033,33 @@ void testExponentiation()
 
 }
 
+#ifdef PINTPMR
+/* a batch of arithmetic on an arena, the result is copied out before the arena is released */
+void testResourceScope()
+{
+    pIntClass a = exponentiation(3, 2000);
+    pIntClass b = exponentiation(7, 1500);
+    pIntClass expected = a * b - a * 12345 + b;
+    pIntClass result;
+
+    std::pmr::monotonic_buffer_resource arena;
+    {
+        pIntResourceScope scope(&arena);
+        pIntClass x = a;
+        pIntClass y = b;
+        pIntClass t = x * y - x * 12345 + y;   // a * b has 2222 digits, through Karatsuba
+        pIntClass q;
+        RemQuotient(t, y, &q);
+        result = t;
+        if (pIntClass::GetResource() != &arena) std::cout << "resource not set" << std::endl;
+    }
+    if (pIntClass::GetResource() != std::pmr::new_delete_resource()) std::cout << "resource not restored" << std::endl;
+    arena.release();
+
+    std::cout << "resource scope " << ((result == expected) ? "ok" : "failed") << std::endl;
+}
+#endif
+
 #define TESTLENGTH 100
 void testLeaks()
 {
@@ -220,13 +1097,44 @@ int main()
 {
 
 
+    testFilterPrimesFirst();        // must be the first primality test in the process
     testLeaks();
+#ifdef PINTPMR
+    testResourceScope();
+#endif
     testMR();
     testExponentiation();
     testSubtraction();
     testAddition();
+    testExpressions();
+    testDecimalShift();
+    testPow2();
     testMultiplication();
     testModMult();
+    testAddMul();
+    testKnuthQuotientReminder();
+    testBurnikelZieglerQuotientReminder();
+    testNewtonQuotientReminder();
+#ifdef SSLIMIT
+    testFFTMultiplication();
+#endif
+    testDivModInt();
+    testMontgomery();
+    testBarrett();
+    testModPow();
+    testFixedBasePow();
+    testMultiPow();
+    testGcd();
+    testJacobi();
+    testModReducer();
+    testBatchModInverse();
+    testCrt();
+    testSmallFactor();
+    testBPSW();
+    testMRThreads();
+    testFilterPrimes();
+    testRoots();
+    testRns();
     testTonelliShanks();
 
 
@@ -22,20 +22,41 @@ If this is what you want to do, use the GNU Library General Public License inste
 ****************************************************************************/
 
 
-pIntClass::pIntClass()
+#ifdef PINTPMR
+static thread_local std::pmr::memory_resource* CurrentResource = NULL;
+
+std::pmr::memory_resource* pIntClass::SetResource(std::pmr::memory_resource* resource)
+{
+	std::pmr::memory_resource* previous = GetResource();
+	CurrentResource = resource;
+	return previous;
+}
+
+std::pmr::memory_resource* pIntClass::GetResource()
+{
+	return (CurrentResource != NULL) ? CurrentResource : std::pmr::new_delete_resource();
+}
+
+pIntVector::allocator_type pIntClass::Allocator() { return pIntVector::allocator_type(GetResource()); }
+#else
+pIntVector::allocator_type pIntClass::Allocator() { return pIntVector::allocator_type(); }
+#endif
+
+
+pIntClass::pIntClass() : value(Allocator())
 {
 	value.clear();
 	value.reserve(ReservationSize);
 }
 
-pIntClass::pIntClass(const pIntClass& x)
+pIntClass::pIntClass(const pIntClass& x) : value(Allocator())
 {
 	value.clear();
 	value.reserve(ReservationSize);
 	for (int i = 0; i < x.value.size(); i++) value.push_back(x.value[i]);
 }
 
-pIntClass::pIntClass(const int x)
+pIntClass::pIntClass(const int x) : value(Allocator())
 {
 	int _x = x;
 	value.clear();
@@ -62,7 +83,7 @@ pIntClass::pIntClass(const int x)
 *	   Addition and Subtraktion may temporarily make a value not normalized,
 *	   normalize will bring it back in order.
 */
-void pIntClass::normalize(std::vector<int>& val) {
+void pIntClass::normalize(pIntVector& val) {
 	// drop leading zeroes
 	while (val.size() && (val.back() == 0)) val.pop_back();
 	if (val.size()) {
@@ -189,18 +210,66 @@ bool pIntClass::IsBiggerNummerically(const pIntClass& b)
 	return false;
 }
 
-void pIntClass::DivModulus() {
-	switch (value.size())
-	{
-	case 0: 		break;
-	default:
-		for (int ix = 0; value.size() && (ix < (value.size() - 1)); ix++)
-		{
-			value[ix] = value[ix + 1];
+/* this *= MODULUS^limbs */
+pIntClass& pIntClass::ShiftLimbsLeft(const unsigned int limbs)
+{
+	if (limbs && value.size())
+		value.insert(value.begin(), limbs, 0);
+	return *this;
+}
+
+/* this /= MODULUS^limbs, truncated towards 0 */
+pIntClass& pIntClass::ShiftLimbsRight(const unsigned int limbs)
+{
+	if (limbs >= value.size())
+		value.clear();
+	else if (limbs)
+		value.erase(value.begin(), value.begin() + limbs);
+	return *this;
+}
+
+static const int Pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+/* this *= 10^digits */
+pIntClass& pIntClass::MulPow10(const unsigned int digits)
+{
+	ShiftLimbsLeft(digits / 9);
+	Scale(Pow10[digits % 9]);
+	return *this;
+}
+
+/* this = this / 10^digits (truncated), returns this % 10^digits (with the sign of this) */
+pIntClass pIntClass::DivPow10(const unsigned int digits)
+{
+	pIntClass rem;
+	unsigned int limbs = std::min((unsigned int)value.size(), digits / 9);
+	rem.value.assign(value.begin(), value.begin() + limbs);
+	normalize(rem.value);
+	ShiftLimbsRight(digits / 9);
+	if (value.size() && (digits % 9)) {
+		int r = DivSmall(Pow10[digits % 9]);
+		if (r) {
+			pIntClass high(r);
+			high.ShiftLimbsLeft(limbs);
+			rem += high;
 		}
-		value.pop_back();
-		break;
 	}
+	return rem;
+}
+
+/* this = this / 10^digits rounded to nearest, halves away from 0 */
+pIntClass& pIntClass::DivPow10Rounded(const unsigned int digits)
+{
+	if (digits == 0) return *this;
+	int sign = Sign();
+	pIntClass rem = DivPow10(digits);
+	pIntClass half(5);
+	half.MulPow10(digits - 1);
+	if (!half.IsBiggerNummerically(rem)) {
+		if (sign > 0) ++(*this);
+		else --(*this);
+	}
+	return *this;
 }
 
 
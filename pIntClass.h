@@ -23,6 +23,7 @@ If this is what you want to do, use the GNU Library General Public License inste
 
 #include <vector>
 #include <string>
+#include <cstdint>
 
 
 #if OS_WINDOWS   // windows
@@ -61,11 +62,98 @@ typedef  int64_t  s64;
 */
 
 
-/* undefine if you don't want to include Schnhage-Strassen multiplication */
-#define SSLIMIT 220
+/* base of pIntClass and of the expression nodes in pIntClassExpr.h */
+template <class E> class pIntExpr {
+public:
+    const E& Self() const { return static_cast<const E&>(*this); }
+};
+
+class pIntLeaf;
+template <class E> class pIntScaleExpr;
+template <class L, class R> class pIntMulExpr;
+
+
+/*
+*     undefine if you don't want the digits allocated through a std::pmr::memory_resource
+*     (needs C++17). With PINTPMR defined every pIntClass takes its memory resource from
+*     the thread it is constructed on, see SetResource() and pIntResourceScope below.
+*/
+#define PINTPMR
+
+#ifdef PINTPMR
+#include <memory_resource>
+typedef std::pmr::vector<int> pIntVector;
+#else
+typedef std::vector<int> pIntVector;
+#endif
+
+
+/*
+*   undefine if you don't want to include Schnhage-Strassen multiplication.
+*   Products with a.size() + b.size() >= SSLIMIT use the FFT, Karatsuba was still
+*   10 times faster at 100000 limbs each (-O1, linux)
+*/
+#define SSLIMIT 2000000
+
+/* operands of at least KARATSUBALIMIT limbs each are multiplied by Karatsuba below SSLIMIT */
+#define KARATSUBALIMIT 40
+
+/*
+*   RemQuotient uses Knuth's Algorithm D for divisors below 2 * BZLIMIT limbs and
+*   Burnikel-Ziegler division above, which recurses down to Algorithm D on
+*   BZLIMIT / 2 to BZLIMIT limbs. Newton reciprocal division costs about 3.5 times
+*   Burnikel-Ziegler division with Karatsuba multiplication, so it is only used
+*   once the products go through the FFT.
+*/
+#define BZLIMIT 160
+#ifdef SSLIMIT
+#define NEWTONLIMIT (SSLIMIT / 2)
+#endif
+/* reciprocals of at most NEWTONBASE limbs are computed by plain division */
+#define NEWTONBASE 6
+
+
+/*
+*   A machine word divisor 0 < d < 2^32 with the precomputed reciprocal floor((2^64 - 1) / d).
+*   q = (t * reciprocal) >> 64 is t / d or one less for t < 2^64, so a division step
+*   is a multiplication and a correction instead of a hardware divide.
+*/
+#if OS_WINDOWS
+#include <intrin.h>
+#endif
 
+class pIntDivisor {
+public:
+    pIntDivisor() : d(1), reciprocal(~(u64)0) {};
+    pIntDivisor(const uint32_t _d) : d(_d), reciprocal(0) {
+        if (d == 0) {
+            std::cout << "divison by zero" << std::endl;
+            d = 1;
+        }
+        reciprocal = (~(u64)0) / d;
+    };
+
+    uint32_t Divisor() const { return d; }
+
+    /* returns t / d, rem = t % d */
+    inline u64 DivRem(const u64 t, u64& rem) const {
+#if OS_WINDOWS
+        u64 q = __umulh(t, reciprocal);
+#else
+        u64 q = (u64)(((unsigned __int128)t * reciprocal) >> 64);
+#endif
+        rem = t - q * d;
+        if (rem >= d) { rem -= d; q++; }
+        return q;
+    }
 
-class pIntClass {
+private:
+    uint32_t d;
+    u64 reciprocal;
+};
+
+
+class pIntClass : public pIntExpr<pIntClass> {
 
 public:
 
@@ -73,12 +161,23 @@ public:
     pIntClass(const pIntClass &x);
     pIntClass(const std::string  &x);
     pIntClass(const int x);
+    template <class E> pIntClass(const pIntExpr<E>& x);
 
     ~pIntClass();
 
     static const int ReservationSize = 8;
     static const int MODULUS = 1000000000;
 
+#ifdef PINTPMR
+    /*
+    *  Memory resource for pIntClass objects constructed on the calling thread from now on,
+    *  NULL means std::pmr::new_delete_resource(). Returns the previous resource.
+    *  An object keeps the resource it was constructed with, so it must not outlive it.
+    */
+    static std::pmr::memory_resource* SetResource(std::pmr::memory_resource* resource);
+    static std::pmr::memory_resource* GetResource();
+#endif
+
     std::string ToString();
 
     pIntClass& operator+=(const pIntClass& rhs);
@@ -93,19 +192,51 @@ public:
     pIntClass& operator-=(const int rhs);
     pIntClass  operator=(const int  rhs);
 
+    /* expressions are evaluated here, see pIntClassExpr.h */
+    template <class E> pIntClass& operator=(const pIntExpr<E>& rhs);
+    template <class E> pIntClass& operator+=(const pIntExpr<E>& rhs);
+    template <class E> pIntClass& operator-=(const pIntExpr<E>& rhs);
+
 
 
 
+    /* this += a * b  and  this -= a * b  without a product temporary */
+    pIntClass& AddMul(const pIntClass& a, const pIntClass& b);
+    pIntClass& SubMul(const pIntClass& a, const pIntClass& b);
+    pIntClass& AddMul(const pIntClass& a, const int b);
+    pIntClass& SubMul(const pIntClass& a, const int b);
+
     pIntClass& operator<<=(const unsigned int shift);
     pIntClass& operator>>=(const unsigned int shift);
 
+    /* this *= 2^shift,  this /= 2^shift returning the bits shifted out */
+    pIntClass& MulPow2(const unsigned int shift);
+    pIntClass  DivPow2(const unsigned int shift);
+    unsigned int TrailingZeroBits() const; // largest k such that 2^k divides this, 0 for 0
+
+    /* this *= MODULUS^limbs, this /= MODULUS^limbs, and the same by 10^digits */
+    pIntClass& ShiftLimbsLeft(const unsigned int limbs);
+    pIntClass& ShiftLimbsRight(const unsigned int limbs);
+    pIntClass& MulPow10(const unsigned int digits);
+    pIntClass  DivPow10(const unsigned int digits);   // truncates, returns the remainder
+    pIntClass& DivPow10Rounded(const unsigned int digits);
+
+    /* this = floor(this / d), returns this mod d in [0, d[ (the remainder of RemQuotient) */
+    uint32_t DivModInt(const uint32_t d);
+    uint32_t DivModInt(const pIntDivisor& d);
+    /* this mod d in [0, d[ */
+    uint32_t ModInt(const uint32_t d) const;
+    uint32_t ModInt(const pIntDivisor& d) const;
+    /* remainders[i] = this mod divisors[i] for all the divisors in one pass over the digits */
+    void ModInts(const pIntDivisor* divisors, size_t count, uint32_t* remainders) const;
+
     pIntClass& operator++();
     pIntClass operator++(int dummy);
     pIntClass& operator--();
     pIntClass operator--(int dummy);
 
     int operator[](int index); // not really an array
-    int Size() {   return (int) value.size();   };
+    int Size() const {   return (int) value.size();   };
     int Sign();   // 0 for 0, 1 for positive, -1 for negative
     int ChSignBit(); // returns the new value of the sign
     inline bool IsZero() const { return value.size() == 0; } // == 0
@@ -118,44 +249,84 @@ public:
     bool operator!=(const pIntClass& b);
     bool IsBiggerNummerically(const pIntClass& b);
 
-    friend pIntClass  operator+(const pIntClass &a, const pIntClass &b);
-    friend pIntClass  operator-(const pIntClass& a, const pIntClass& b);
-    friend pIntClass  operator*(const pIntClass& a, const pIntClass& b);
-
     friend bool operator<(const pIntClass& a, const pIntClass& b);
     friend bool operator==(const pIntClass& a, const pIntClass& b);
     friend bool operator!=(const pIntClass& a, const pIntClass& b);
 
-    friend pIntClass operator+(const int a, const pIntClass &b);
-    friend pIntClass operator-(const int a, const pIntClass& b);
-    friend pIntClass operator*(const int a, const pIntClass &b);
-
 
     friend int Jacobi(const pIntClass& a, const pIntClass& b);
     friend pIntClass RemQuotient(const pIntClass& A, const pIntClass& M, pIntClass *Quotient);
 
     friend class pIntClassRandom;
+    friend class MontgomeryContext;
+    friend class BarrettContext;
+    friend class ModReducer;
+    friend class pIntLeaf;
+    friend class pIntTest;      // the tests in pInt.cpp call Newton division and the FFT below their limits
+    template <class E> friend class pIntScaleExpr;
+    template <class L, class R> friend class pIntMulExpr;
 
 private:
 
     void mul10();
-    void normalize(std::vector<int> &value);
+    static pIntVector::allocator_type Allocator();
+    void normalize(pIntVector &value);
     void Scale(int scale);
-    void DivModulus();
+    void ShiftLeftBits(unsigned int bits);
+    int  ShiftRightBits(unsigned int bits);
+    int  DivSmall(int divisor);
+
+    template <class E> void Assign(const E& e);
+    /* this += sign * a * b and this += sign * a * k, the result is not normalized */
+    void MulAccumulate(const pIntClass& a, const pIntClass& b, int sign);
+    void MulAccumulate(const pIntClass& a, const int k, int sign);
+
+    /* division of non-negative numbers, see pIntClassDivide.cpp */
+    static void KnuthDivide(const pIntClass& A, const pIntClass& M, pIntClass& Q, pIntClass& R);
+    static void BurnikelZieglerDivide(const pIntClass& A, const pIntClass& M, pIntClass& Q, pIntClass& R);
+    static void Div2n1n(const pIntClass& A, const pIntClass& B, size_t n, pIntClass& Q, pIntClass& R);
+    static void Div3n2n(const pIntClass& A, const pIntClass& B, size_t h, pIntClass& Q, pIntClass& R);
+    static pIntClass Limbs(const pIntClass& A, size_t from, size_t count);
+    static pIntClass Reciprocal(const pIntClass& D, size_t h);
+    static void NewtonStep(const pIntClass& A, const pIntClass& M, const pIntClass& X, size_t h, pIntClass& Q, pIntClass& R);
+    static void NewtonDivide(const pIntClass& A, const pIntClass& M, pIntClass& Q, pIntClass& R);
 
     /* schoolbook multiplication */
     pIntClass SchoolbookMultiplication(const pIntClass& rhs);
-    //pIntClass& KaratsubaMultiplication(const pIntClass& rhs);
+    /* Karatsuba multiplication, r[0 .. na + nb - 1] = a * b on magnitudes, r is 0 on entry */
+    pIntClass KaratsubaMultiplication(const pIntClass& rhs);
+    static void KaratsubaMul(const int* a, size_t na, const int* b, size_t nb, int* r);
 
 
 #ifdef SSLIMIT
     pIntClass SchoenhageStrassenMultiplication(const pIntClass& rhs);
+    bool SchoenhageStrassenAccumulate(const pIntClass& a, const pIntClass& b, int sign, bool replace);
 
-    void LoadFFT(const std::vector<int> &A, double* Buffer);
+    void LoadFFT(const pIntVector &A, double* Buffer);
     void Carry(s64 size, double* Buffer);
 #endif
 
-    std::vector<int> value;
+    pIntVector value;
 };
 
+#ifdef PINTPMR
+/*
+*   Sets the memory resource of the calling thread for the lifetime of the scope, e.g.
+*
+*        std::pmr::monotonic_buffer_resource arena;
+*        {
+*            pIntResourceScope scope(&arena);
+*            ... the pIntClass objects of the batch ...
+*        }
+*        arena.release();
+*/
+class pIntResourceScope {
+public:
+    pIntResourceScope(std::pmr::memory_resource* resource) { previous = pIntClass::SetResource(resource); };
+    ~pIntResourceScope() { pIntClass::SetResource(previous); };
+private:
+    std::pmr::memory_resource* previous;
+};
+#endif
 
+#include "pIntClassExpr.h"
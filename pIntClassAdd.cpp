@@ -60,39 +60,6 @@ pIntClass& pIntClass::operator+=(const int rhs)
 }
 
 
-pIntClass operator+(const pIntClass& a, const pIntClass& b)
-{
-	pIntClass t;
-	t = a;
-	t += b;
-	return t;
-}
-
-pIntClass operator-(pIntClass& a, const pIntClass& b)
-{
-	pIntClass t;
-	t = a;
-	t -= b;
-	return t;
-}
-
-
-pIntClass operator+(const int a, const pIntClass& b)
-{
-	pIntClass t;// = new pIntClass();
-	t = a;
-	t += b;
-	return t;
-}
-
-pIntClass operator-(const int a, const pIntClass& b)
-{
-	pIntClass t;// = new pIntClass();
-	t = a;
-	t -= b;
-	return t;
-}
-
 void testAddition()
 {
 
@@ -161,3 +128,21 @@ void testSubtraction()
 	std::cout << " b = -(a - 7) " << b.ToString() << std::endl;
 }
 
+void testExpressions()
+{
+	pIntClass a("2628461924971");
+	pIntClass b("99999999999999999");
+	pIntClass c;
+
+	c = a + b - 7 + 10;
+	std::cout << " c = a + b - 7 + 10 " << c.ToString() << std::endl;
+
+	c = a * b + a;
+	std::cout << " c = a * b + a " << c.ToString() << std::endl;
+
+	c = a - 3 * b;
+	std::cout << " c = a - 3 * b " << c.ToString() << std::endl;
+
+	c = c * c - c;
+	std::cout << " c = c * c - c " << c.ToString() << std::endl;
+}
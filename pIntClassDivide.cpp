@@ -0,0 +1,364 @@
+/*
+Copyright   2024 Claus Vind - Andreasen
+
+This program is free software; you can redistribute it and /or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU General Public License for more details.
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111 - 1307 USA
+This General Public License does not permit incorporating your program into proprietary programs.If your program is a subroutine library, you may consider it more useful to permit linking proprietary applications with the library.
+If this is what you want to do, use the GNU Library General Public License instead of this License.
+*/
+
+#include <iostream>
+#include "pIntClass.h"
+
+pIntClass RemQuotient(const pIntClass& A, const pIntClass& M, pIntClass* Quotient);
+
+/*
+*   Division of non-negative numbers, A = Q * M + R,  0 <= R < M.
+*   B is the radix MODULUS, n the number of limbs in M.
+*
+*   Knuth's Algorithm D (TAOCP vol. 2, 4.3.1) is the schoolbook long division, one
+*   quotient digit per pass over M, O(m * n) for an m limb quotient.
+*
+*   Burnikel-Ziegler division (MPI-I-98-1-022) splits a 2n / n division into two 3n/2 / n
+*   divisions, each of which is a n / n/2 division and a n/2 x n/2 multiplication, so
+*   it runs at the speed of the (Karatsuba) multiplication.
+*
+*   Newton division computes X = floor(B^(2h) / Dh), Dh the h most significant
+*   limbs of M, by Newton iteration doubling the precision at each step, so it
+*   costs a few multiplications of the final size. The quotient is then
+*   floor(A / B^(n-h)) * X / B^(2h), which is at most a few units off.
+*/
+
+/*
+*   Division by a machine word, one pass from the most significant digit with the
+*   remainder < d carried in a u64, t = rem * MODULUS + digit < 2^32 * MODULUS.
+*   The magnitude is divided, then quotient and remainder are adjusted so the
+*   remainder is in [0, d[ like the remainder of RemQuotient.
+*/
+uint32_t pIntClass::DivModInt(const uint32_t d)
+{
+	return DivModInt(pIntDivisor(d));
+}
+
+uint32_t pIntClass::DivModInt(const pIntDivisor& d)
+{
+	if (value.size() == 0) return 0;
+	bool negative = value.back() < 0;
+	u64 rem = 0;
+	for (size_t i = value.size(); i > 0; i--)
+	{
+		u64 t = rem * MODULUS + (u64)(negative ? -value[i - 1] : value[i - 1]);
+		int q = (int)d.DivRem(t, rem);
+		value[i - 1] = negative ? -q : q;
+	}
+	while (value.size() && (value.back() == 0)) value.pop_back();
+	if (negative && rem) {
+		--(*this);
+		rem = d.Divisor() - rem;
+	}
+	return (uint32_t)rem;
+}
+
+uint32_t pIntClass::ModInt(const uint32_t d) const
+{
+	return ModInt(pIntDivisor(d));
+}
+
+uint32_t pIntClass::ModInt(const pIntDivisor& d) const
+{
+	uint32_t rem;
+	ModInts(&d, 1, &rem);
+	return rem;
+}
+
+void pIntClass::ModInts(const pIntDivisor* divisors, size_t count, uint32_t* remainders) const
+{
+	for (size_t j = 0; j < count; j++) remainders[j] = 0;
+	if (value.size() == 0) return;
+	bool negative = value.back() < 0;
+	for (size_t i = value.size(); i > 0; i--)
+	{
+		u64 digit = (u64)(negative ? -value[i - 1] : value[i - 1]);
+		for (size_t j = 0; j < count; j++) {
+			u64 rem;
+			divisors[j].DivRem((u64)remainders[j] * MODULUS + digit, rem);
+			remainders[j] = (uint32_t)rem;
+		}
+	}
+	if (negative)
+		for (size_t j = 0; j < count; j++)
+			if (remainders[j]) remainders[j] = divisors[j].Divisor() - remainders[j];
+}
+
+/* A >= 0, M > 0 */
+void pIntClass::KnuthDivide(const pIntClass& A, const pIntClass& M, pIntClass& Q, pIntClass& R)
+{
+	size_t n = M.value.size();
+
+	if (A < M) {
+		Q = 0;
+		R = A;
+		return;
+	}
+	if (n == 1) {
+		Q = A;
+		R = Q.DivSmall(M.value[0]);
+		return;
+	}
+
+	/* scale so the top digit of the divisor is >= MODULUS / 2, then the two digit
+	   estimate of a quotient digit is at most 2 too big */
+	size_t m = A.value.size() - n;
+	int d = MODULUS / (M.value.back() + 1);
+	pIntVector u(A.value, Allocator());
+	pIntVector v(M.value, Allocator());
+	u.push_back(0);
+	s64 carry = 0;
+	for (size_t i = 0; i < v.size(); i++) {
+		s64 t = (s64)v[i] * d + carry;
+		carry = t / MODULUS;
+		v[i] = (int)(t - carry * MODULUS);
+	}
+	carry = 0;
+	for (size_t i = 0; i < u.size(); i++) {
+		s64 t = (s64)u[i] * d + carry;
+		carry = t / MODULUS;
+		u[i] = (int)(t - carry * MODULUS);
+	}
+
+	Q.value.assign(m + 1, 0);
+	s64 vtop = v[n - 1];
+	s64 vnext = v[n - 2];
+	for (size_t j = m + 1; j > 0; j--) {
+		size_t k = j - 1;
+		s64 num = (s64)u[k + n] * MODULUS + u[k + n - 1];
+		s64 qhat = num / vtop;
+		s64 rhat = num % vtop;
+		while ((qhat >= MODULUS) || (qhat * vnext > rhat * MODULUS + u[k + n - 2])) {
+			qhat--;
+			rhat += vtop;
+			if (rhat >= MODULUS) break;
+		}
+
+		/* u[k .. k + n] -= qhat * v */
+		s64 borrow = 0;
+		carry = 0;
+		for (size_t i = 0; i < n; i++) {
+			s64 p = qhat * v[i] + carry;
+			carry = p / MODULUS;
+			s64 t = u[i + k] - (p - carry * MODULUS) + borrow;
+			borrow = (t < 0) ? -1 : 0;
+			u[i + k] = (int)(t - borrow * MODULUS);
+		}
+		s64 t = u[k + n] - carry + borrow;
+
+		/* qhat was one too big, add v back */
+		if (t < 0) {
+			qhat--;
+			carry = 0;
+			for (size_t i = 0; i < n; i++) {
+				s64 a = (s64)u[i + k] + v[i] + carry;
+				carry = (a >= MODULUS) ? 1 : 0;
+				u[i + k] = (int)(a - carry * MODULUS);
+			}
+			t += carry;
+		}
+		u[k + n] = (int)t;
+		Q.value[k] = (int)qhat;
+	}
+	Q.normalize(Q.value);
+
+	u.resize(n);
+	R.value.assign(u.begin(), u.end());
+	R.normalize(R.value);
+	R.DivSmall(d);
+}
+
+/* A[from .. from + count - 1] */
+pIntClass pIntClass::Limbs(const pIntClass& A, size_t from, size_t count)
+{
+	pIntClass T;
+	if (from < A.value.size())
+		T.value.assign(A.value.begin() + from, A.value.begin() + std::min(A.value.size(), from + count));
+	T.normalize(T.value);
+	return T;
+}
+
+/* A < B * B^n, B has n limbs and its top limb is >= MODULUS / 2 */
+void pIntClass::Div2n1n(const pIntClass& A, const pIntClass& B, size_t n, pIntClass& Q, pIntClass& R)
+{
+	if ((n & 1) || (n <= BZLIMIT)) {
+		KnuthDivide(A, B, Q, R);
+		return;
+	}
+	size_t h = n / 2;
+	pIntClass Q1;
+	pIntClass R1;
+	Div3n2n(Limbs(A, h, 3 * h), B, h, Q1, R1);
+	R1.ShiftLimbsLeft((unsigned int)h);
+	R1 += Limbs(A, 0, h);
+	Div3n2n(R1, B, h, Q, R);
+	Q1.ShiftLimbsLeft((unsigned int)h);
+	Q += Q1;
+}
+
+/* A < B * B^h, B has 2h limbs and its top limb is >= MODULUS / 2 */
+void pIntClass::Div3n2n(const pIntClass& A, const pIntClass& B, size_t h, pIntClass& Q, pIntClass& R)
+{
+	pIntClass B1 = Limbs(B, h, h);
+	pIntClass B2 = Limbs(B, 0, h);
+	pIntClass A12 = Limbs(A, h, 2 * h);
+
+	if (Limbs(A, 2 * h, h) < B1) {
+		Div2n1n(A12, B1, h, Q, R);
+	}
+	else {
+		/* Q = B^h - 1, R = A12 - Q * B1 */
+		Q = 1;
+		Q.ShiftLimbsLeft((unsigned int)h);
+		--Q;
+		R = A12;
+		R += B1;
+		B1.ShiftLimbsLeft((unsigned int)h);
+		R -= B1;
+	}
+
+	/* R = R * B^h + A3 - Q * B2, at most 2 corrections with B normalized */
+	R.ShiftLimbsLeft((unsigned int)h);
+	R += Limbs(A, 0, h);
+	R.SubMul(Q, B2);
+	while (R.IsNeg()) {
+		R += B;
+		--Q;
+	}
+}
+
+/* A >= 0, M > 0 */
+void pIntClass::BurnikelZieglerDivide(const pIntClass& A, const pIntClass& M, pIntClass& Q, pIntClass& R)
+{
+	if (A < M) {
+		Q = 0;
+		R = A;
+		return;
+	}
+
+	/* normalize the top limb as in Algorithm D, and pad the divisor with zero limbs to
+	   j * 2^k limbs, j <= BZLIMIT, so it can be halved all the way down to Algorithm D */
+	int d = MODULUS / (M.value.back() + 1);
+	size_t m = 1;
+	while (M.value.size() > m * BZLIMIT) m *= 2;
+	size_t n = ((M.value.size() + m - 1) / m) * m;
+	size_t pad = n - M.value.size();
+
+	pIntClass B(M);
+	pIntClass A1(A);
+	B.Scale(d);
+	A1.Scale(d);
+	B.ShiftLimbsLeft((unsigned int)pad);
+	A1.ShiftLimbsLeft((unsigned int)pad);
+
+	/* the dividend is divided n limbs at a time, R < B carried from block to block */
+	size_t blocks = (A1.value.size() + n - 1) / n;
+	Q.value.assign(blocks * n, 0);
+	R = 0;
+	for (size_t b = blocks; b > 0; b--) {
+		R.ShiftLimbsLeft((unsigned int)n);
+		R += Limbs(A1, (b - 1) * n, n);
+		pIntClass q;
+		pIntClass r;
+		Div2n1n(R, B, n, q, r);
+		R = r;
+		for (size_t i = 0; i < q.value.size(); i++) Q.value[(b - 1) * n + i] = q.value[i];
+	}
+	Q.normalize(Q.value);
+
+	R.ShiftLimbsRight((unsigned int)pad);
+	R.DivSmall(d);
+}
+
+/* floor(B^(2h) / Dh), Dh the h most significant limbs of D > 0 */
+pIntClass pIntClass::Reciprocal(const pIntClass& D, size_t h)
+{
+	pIntClass Dh(D);
+	Dh.ShiftLimbsRight((unsigned int)(D.value.size() - h));
+
+	pIntClass X;
+	pIntClass E(1);
+	E.ShiftLimbsLeft((unsigned int)(2 * h));
+
+	if (h <= NEWTONBASE) {
+		RemQuotient(E, Dh, &X);
+		return X;
+	}
+
+	/* X from l > h/2 limbs has a relative error < B^-(l-1), one step squares it */
+	size_t l = (h + 1) / 2 + 2;
+	X = Reciprocal(Dh, l);
+	X.ShiftLimbsLeft((unsigned int)(h - l));
+
+	E.SubMul(Dh, X);                 // E = B^(2h) - Dh * X
+	pIntClass T = X * E;
+	T.ShiftLimbsRight((unsigned int)(2 * h));
+	X += T;                          // X = X + X * E / B^(2h)
+
+	/* correct the last few units */
+	E = 1;
+	E.ShiftLimbsLeft((unsigned int)(2 * h));
+	E.SubMul(Dh, X);
+	while (E.IsNeg()) { --X; E += Dh; }
+	while (!(E < Dh)) { ++X; E -= Dh; }
+	return X;
+}
+
+/* A < B^n * M, X = Reciprocal(M, h) */
+void pIntClass::NewtonStep(const pIntClass& A, const pIntClass& M, const pIntClass& X, size_t h, pIntClass& Q, pIntClass& R)
+{
+	pIntClass T(A);
+	T.ShiftLimbsRight((unsigned int)(M.value.size() - h));
+	Q = T * X;
+	Q.ShiftLimbsRight((unsigned int)(2 * h));
+
+	R = A;
+	R.SubMul(Q, M);
+	while (R.IsNeg()) { R += M; --Q; }
+	while (!(R < M)) { R -= M; ++Q; }
+}
+
+void pIntClass::NewtonDivide(const pIntClass& A, const pIntClass& M, pIntClass& Q, pIntClass& R)
+{
+	size_t n = M.value.size();
+
+	if (A.value.size() < n) {
+		Q = 0;
+		R = A;
+	}
+	else if (A.value.size() <= 2 * n) {
+		size_t h = std::min(n, A.value.size() - n + 3);
+		pIntClass X = Reciprocal(M, h);
+		NewtonStep(A, M, X, h, Q, R);
+	}
+	else {
+		/* long dividends are divided n limbs at a time with the same reciprocal */
+		pIntClass X = Reciprocal(M, n);
+		size_t blocks = (A.value.size() + n - 1) / n;
+
+		Q.value.assign(blocks * n, 0);
+		R = 0;
+		for (size_t b = blocks; b > 0; b--) {
+			pIntClass Block;
+			size_t end = std::min(b * n, A.value.size());
+			Block.value.assign(A.value.begin() + (b - 1) * n, A.value.begin() + end);
+			Block.normalize(Block.value);
+			R.ShiftLimbsLeft((unsigned int)n);
+			R += Block;
+
+			pIntClass q;
+			pIntClass r;
+			NewtonStep(R, M, X, n, q, r);
+			R = r;
+			for (size_t i = 0; i < q.value.size(); i++) Q.value[(b - 1) * n + i] = q.value[i];
+		}
+		Q.normalize(Q.value);
+	}
+}
@@ -0,0 +1,230 @@
+#pragma once
+/*
+Copyright   2024 Claus Vind - Andreasen
+
+This program is free software; you can redistribute it and /or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU General Public License for more details.
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111 - 1307 USA
+This General Public License does not permit incorporating your program into proprietary programs.If your program is a subroutine library, you may consider it more useful to permit linking proprietary applications with the library.
+If this is what you want to do, use the GNU Library General Public License instead of this License.
+*/
+
+#include <algorithm>
+#include "pIntClass.h"
+
+/*
+*     Expression templates for pIntClass.
+*
+*     a + b - c + 7 does not compute anything, it builds a small tree of nodes
+*     which is evaluated when it is assigned to a pIntClass (or used to construct one).
+*
+*     Each node provides
+*
+*        Length()      upper bound on the number of digits in the 'linear' part
+*        Limb(i)       the i'th digit of the linear part (sums of digits, not normalized)
+*        Accumulate()  adds the non-linear terms (a * b, k * a) to the destination
+*        Refers(p)     true if the expression reads the pIntClass p
+*
+*     The linear part (sums and differences of pIntClass and int) is evaluated in a
+*     single pass with one carry chain and one normalize(), the non-linear terms
+*     are accumulated directly into the destination with MulAccumulate.
+*
+*     The nodes keep references to their pIntClass operands, so an expression must
+*     be assigned in the same statement as it is created, e.g. don't use 'auto x = a + b;'
+*/
+
+
+/* pIntClass operands are kept by reference, everything else by value */
+class pIntLeaf : public pIntExpr<pIntLeaf> {
+public:
+    static const bool Linear = true;
+
+    pIntLeaf(const pIntClass& _v) : v(_v) {};
+
+    size_t Length() const { return v.value.size(); }
+    s64 Limb(size_t i) const { return (i < v.value.size()) ? v.value[i] : 0; }
+    void Accumulate(pIntClass& dst, int sign) const { (void)dst; (void)sign; }
+    bool Refers(const pIntClass* p) const { return p == &v; }
+    const pIntClass& Value() const { return v; }
+
+private:
+    const pIntClass& v;
+};
+
+template <class E> struct pIntExprStore { typedef E type; };
+template <> struct pIntExprStore<pIntClass> { typedef pIntLeaf type; };
+
+
+class pIntScalar : public pIntExpr<pIntScalar> {
+public:
+    static const bool Linear = true;
+
+    pIntScalar(const int _x) : x(_x) {};
+
+    size_t Length() const { return 2; }
+    s64 Limb(size_t i) const {
+        switch (i) {
+        case 0:  return x % pIntClass::MODULUS;
+        case 1:  return x / pIntClass::MODULUS;
+        default: return 0;
+        }
+    }
+    void Accumulate(pIntClass& dst, int sign) const { (void)dst; (void)sign; }
+    bool Refers(const pIntClass* p) const { (void)p; return false; }
+
+private:
+    int x;
+};
+
+
+/* L + R  (Sign == 1)  or L - R (Sign == -1) */
+template <class L, class R, int Sign>
+class pIntAddExpr : public pIntExpr<pIntAddExpr<L, R, Sign> > {
+public:
+    static const bool Linear = pIntExprStore<L>::type::Linear && pIntExprStore<R>::type::Linear;
+
+    pIntAddExpr(const L& _l, const R& _r) : l(_l), r(_r) {};
+
+    size_t Length() const { return std::max(l.Length(), r.Length()); }
+    s64 Limb(size_t i) const { return l.Limb(i) + Sign * r.Limb(i); }
+    void Accumulate(pIntClass& dst, int sign) const {
+        l.Accumulate(dst, sign);
+        r.Accumulate(dst, Sign * sign);
+    }
+    bool Refers(const pIntClass* p) const { return l.Refers(p) || r.Refers(p); }
+
+private:
+    typename pIntExprStore<L>::type l;
+    typename pIntExprStore<R>::type r;
+};
+
+
+/* k * E, E is a pIntClass (by reference) or an already evaluated temporary (by value) */
+template <class E>
+class pIntScaleExpr : public pIntExpr<pIntScaleExpr<E> > {
+public:
+    static const bool Linear = false;
+
+    pIntScaleExpr(const E& _e, const int _k) : e(_e), k(_k) {};
+
+    size_t Length() const { return 0; }
+    s64 Limb(size_t i) const { (void)i; return 0; }
+    void Accumulate(pIntClass& dst, int sign) const { dst.MulAccumulate(e, k, sign); }
+    bool Refers(const pIntClass* p) const { return p == &e; }
+
+private:
+    E e;
+    int k;
+};
+
+
+/* L * R, operands which are not pIntClass are evaluated before the multiplication */
+template <class L, class R>
+class pIntMulExpr : public pIntExpr<pIntMulExpr<L, R> > {
+public:
+    static const bool Linear = false;
+
+    pIntMulExpr(const L& _l, const R& _r) : l(_l), r(_r) {};
+
+    size_t Length() const { return 0; }
+    s64 Limb(size_t i) const { (void)i; return 0; }
+    void Accumulate(pIntClass& dst, int sign) const {
+        const pIntClass& a = Operand(l);
+        const pIntClass& b = Operand(r);
+        dst.MulAccumulate(a, b, sign);
+    }
+    bool Refers(const pIntClass* p) const { return l.Refers(p) || r.Refers(p); }
+
+private:
+    static const pIntClass& Operand(const pIntLeaf& x) { return x.Value(); }
+    template <class E> static pIntClass Operand(const E& x) { return pIntClass(x); }
+
+    typename pIntExprStore<L>::type l;
+    typename pIntExprStore<R>::type r;
+};
+
+
+template <class E>
+pIntClass::pIntClass(const pIntExpr<E>& x) : value(Allocator())
+{
+    value.reserve(ReservationSize);
+    Assign(x.Self());
+}
+
+template <class E>
+pIntClass& pIntClass::operator=(const pIntExpr<E>& rhs)
+{
+    Assign(rhs.Self());
+    return *this;
+}
+
+template <class E>
+pIntClass& pIntClass::operator+=(const pIntExpr<E>& rhs)
+{
+    Assign(pIntAddExpr<pIntClass, E, 1>(*this, rhs.Self()));
+    return *this;
+}
+
+template <class E>
+pIntClass& pIntClass::operator-=(const pIntExpr<E>& rhs)
+{
+    Assign(pIntAddExpr<pIntClass, E, -1>(*this, rhs.Self()));
+    return *this;
+}
+
+template <class E>
+void pIntClass::Assign(const E& _e)
+{
+    typename pIntExprStore<E>::type e(_e);
+
+    /* the non-linear terms read their operands after the linear pass has overwritten us */
+    if (!pIntExprStore<E>::type::Linear && e.Refers(this)) {
+        pIntClass temp;
+        temp.Assign(_e);
+        value = std::move(temp.value);
+        return;
+    }
+
+    /* one pass over the linear part, digit i only depends on operand digits i */
+    size_t length = e.Length();
+    value.resize(length, 0);
+    s64 carry = 0;
+    for (size_t i = 0; i < length; i++) {
+        s64 t = e.Limb(i) + carry;
+        carry = t / MODULUS;
+        value[i] = (int)(t - carry * MODULUS);
+    }
+    while (carry) {
+        value.push_back((int)(carry % MODULUS));
+        carry = carry / MODULUS;
+    }
+
+    e.Accumulate(*this, 1);
+    normalize(value);
+}
+
+
+template <class L, class R>
+pIntAddExpr<L, R, 1> operator+(const pIntExpr<L>& a, const pIntExpr<R>& b) { return pIntAddExpr<L, R, 1>(a.Self(), b.Self()); }
+template <class L>
+pIntAddExpr<L, pIntScalar, 1> operator+(const pIntExpr<L>& a, const int b) { return pIntAddExpr<L, pIntScalar, 1>(a.Self(), pIntScalar(b)); }
+template <class R>
+pIntAddExpr<pIntScalar, R, 1> operator+(const int a, const pIntExpr<R>& b) { return pIntAddExpr<pIntScalar, R, 1>(pIntScalar(a), b.Self()); }
+
+template <class L, class R>
+pIntAddExpr<L, R, -1> operator-(const pIntExpr<L>& a, const pIntExpr<R>& b) { return pIntAddExpr<L, R, -1>(a.Self(), b.Self()); }
+template <class L>
+pIntAddExpr<L, pIntScalar, -1> operator-(const pIntExpr<L>& a, const int b) { return pIntAddExpr<L, pIntScalar, -1>(a.Self(), pIntScalar(b)); }
+template <class R>
+pIntAddExpr<pIntScalar, R, -1> operator-(const int a, const pIntExpr<R>& b) { return pIntAddExpr<pIntScalar, R, -1>(pIntScalar(a), b.Self()); }
+
+template <class L, class R>
+pIntMulExpr<L, R> operator*(const pIntExpr<L>& a, const pIntExpr<R>& b) { return pIntMulExpr<L, R>(a.Self(), b.Self()); }
+
+/* scaling a pIntClass is fused, scaling an expression evaluates the expression first */
+inline pIntScaleExpr<const pIntClass&> operator*(const pIntClass& a, const int b) { return pIntScaleExpr<const pIntClass&>(a, b); }
+inline pIntScaleExpr<const pIntClass&> operator*(const int a, const pIntClass& b) { return pIntScaleExpr<const pIntClass&>(b, a); }
+template <class E>
+pIntScaleExpr<pIntClass> operator*(const pIntExpr<E>& a, const int b) { return pIntScaleExpr<pIntClass>(pIntClass(a), b); }
+template <class E>
+pIntScaleExpr<pIntClass> operator*(const int a, const pIntExpr<E>& b) { return pIntScaleExpr<pIntClass>(pIntClass(b), a); }
@@ -16,7 +16,7 @@ If this is what you want to do, use the GNU Library General Public License inste
 #include "pIntClass.h"
 
 
-pIntClass::pIntClass(const std::string& x)
+pIntClass::pIntClass(const std::string& x) : value(Allocator())
 {
 	value.clear();
 	value.reserve(ReservationSize);
@@ -0,0 +1,683 @@
+/*
+Copyright   2024 Claus Vind - Andreasen
+
+This program is free software; you can redistribute it and /or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU General Public License for more details.
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111 - 1307 USA
+This General Public License does not permit incorporating your program into proprietary programs.If your program is a subroutine library, you may consider it more useful to permit linking proprietary applications with the library.
+If this is what you want to do, use the GNU Library General Public License instead of this License.
+*/
+
+#include <iostream>
+#include <thread>
+#include "pIntClass.h"
+#include "pIntClassModular.h"
+#include "pIntClassUtil.h"
+
+pIntClass RemQuotient(const pIntClass& A, const pIntClass& M, pIntClass* Quotient);
+
+/* the magnitude of e in 30 bit words, least significant first */
+static std::vector<uint32_t> ExponentWords(const pIntClass& e)
+{
+	std::vector<uint32_t> words;
+	pIntClass t(e);
+	if (t.IsNeg()) t.ChSignBit();
+	while (!t.IsZero()) words.push_back(t.DivModInt(1u << 30));
+	return words;
+}
+
+/* the window size for an exponent of the given number of bits, 2^(w-1) odd powers are precomputed */
+static int WindowSize(size_t bits)
+{
+	static const size_t limits[] = { 8, 24, 80, 240, 672, 1792 };
+	int w = 1;
+	while (w <= 6 && bits > limits[w - 1]) w++;
+	return w;
+}
+
+/*
+*   x^e, left to right sliding window over the bits of e, x and the result in the domain of ctx
+*   (Montgomery form or reduced). Every window starts and ends with a set bit, so only odd powers
+*   are needed and there is one multiplication per window instead of one per set bit.
+*/
+template <class Context>
+static pIntClass WindowPow(const Context& ctx, const pIntClass& x, const pIntClass& one, const std::vector<uint32_t>& words)
+{
+	auto bit = [&words](size_t k) { return (words[k / 30] >> (k % 30)) & 1; };
+	size_t bits = 30 * words.size();
+	while (bits > 0 && !bit(bits - 1)) bits--;
+	if (bits == 0) return one;
+
+	int w = WindowSize(bits);
+	std::vector<pIntClass> odd((size_t)1 << (w - 1));   // x, x^3, x^5, ...
+	odd[0] = x;
+	if (w > 1) {
+		pIntClass x2 = ctx.Square(x);
+		for (size_t i = 1; i < odd.size(); i++) odd[i] = ctx.Multiply(odd[i - 1], x2);
+	}
+
+	pIntClass result;
+	bool started = false;
+	size_t i = bits;
+	while (i > 0) {
+		if (!bit(i - 1)) {
+			result = ctx.Square(result);   // started, the top bit is set
+			i--;
+			continue;
+		}
+		size_t j = (i > (size_t)w) ? i - w : 0;   // window bits j .. i - 1
+		while (!bit(j)) j++;
+		uint32_t v = 0;
+		for (size_t k = i; k > j; k--) {
+			v = 2 * v + bit(k - 1);
+			if (started) result = ctx.Square(result);
+		}
+		result = started ? ctx.Multiply(result, odd[v >> 1]) : odd[v >> 1];
+		started = true;
+		i = j;
+	}
+	return result;
+}
+
+/*
+*   prod x[i]^e[i], one squaring chain for all bases (Straus, interleaved sliding windows).
+*   Every base has its own window size and table of odd powers, the window of base i which ends
+*   at bit j is multiplied in when the chain has been squared down to bit j.
+*/
+template <class Context>
+static pIntClass InterleavedPow(const Context& ctx, const std::vector<pIntClass>& x, const pIntClass& one, const std::vector<std::vector<uint32_t> >& words)
+{
+	size_t count = x.size();
+	size_t maxbits = 0;
+	std::vector<std::vector<pIntClass> > odd(count);
+	std::vector<std::vector<uint32_t> > at(count);    // at[i][j] odd window value ending at bit j, or 0
+
+	for (size_t b = 0; b < count; b++) {
+		auto bit = [&words, b](size_t k) { return (words[b][k / 30] >> (k % 30)) & 1; };
+		size_t bits = 30 * words[b].size();
+		while (bits > 0 && !bit(bits - 1)) bits--;
+		if (bits == 0) continue;
+		maxbits = std::max(maxbits, bits);
+
+		int w = WindowSize(bits);
+		odd[b].resize((size_t)1 << (w - 1));
+		odd[b][0] = x[b];
+		if (w > 1) {
+			pIntClass x2 = ctx.Square(x[b]);
+			for (size_t i = 1; i < odd[b].size(); i++) odd[b][i] = ctx.Multiply(odd[b][i - 1], x2);
+		}
+
+		at[b].assign(bits, 0);
+		size_t i = bits;
+		while (i > 0) {
+			if (!bit(i - 1)) { i--; continue; }
+			size_t j = (i > (size_t)w) ? i - w : 0;
+			while (!bit(j)) j++;
+			uint32_t v = 0;
+			for (size_t k = i; k > j; k--) v = 2 * v + bit(k - 1);
+			at[b][j] = v;
+			i = j;
+		}
+	}
+
+	pIntClass result = one;
+	bool started = false;
+	for (size_t k = maxbits; k > 0; k--) {
+		if (started) result = ctx.Square(result);
+		for (size_t b = 0; b < count; b++) {
+			if (k - 1 >= at[b].size() || at[b][k - 1] == 0) continue;
+			const pIntClass& t = odd[b][at[b][k - 1] >> 1];
+			result = started ? ctx.Multiply(result, t) : t;
+			started = true;
+		}
+	}
+	return result;
+}
+
+MontgomeryContext::MontgomeryContext(const pIntClass& modulus) : valid(false), n(0), mprime(0), m(modulus)
+{
+	if (m.IsNeg()) m.ChSignBit();
+	if (m.IsZero() || m.IsOne() || ((m.value[0] & 1) == 0) || ((m.value[0] % 5) == 0)) {
+		std::cout << "Montgomery modulus must be > 1 and coprime to 10" << std::endl;
+		return;
+	}
+	valid = true;
+	n = m.value.size();
+
+	/* 1/m mod 10 by trial, then Hensel lifting x = x * (2 - m * x) doubles the number of correct digits */
+	s64 m0 = m.value[0];
+	s64 x = 1;
+	while ((m0 * x) % 10 != 1) x++;
+	for (int digits = 1; digits < 9; digits *= 2) {
+		s64 t = (m0 * x) % pIntClass::MODULUS;
+		x = (x * ((2 - t + pIntClass::MODULUS) % pIntClass::MODULUS)) % pIntClass::MODULUS;
+	}
+	mprime = (int)((pIntClass::MODULUS - x) % pIntClass::MODULUS);
+
+	/* the same lifting with numbers of up to n limbs for -1/m mod R */
+	pIntClass inv((int)x);
+	for (size_t limbs = 1; limbs < n; limbs *= 2) {
+		size_t l = std::min(2 * limbs, n);
+		pIntClass t = pIntClass::Limbs(m, 0, l) * inv;
+		t = pIntClass::Limbs(t, 0, l);
+		pIntClass two(2);
+		two.ShiftLimbsLeft((unsigned int)l);   // 2 - t mod B^l
+		two += 2;
+		two -= t;
+		inv *= two;
+		inv = pIntClass::Limbs(inv, 0, l);
+	}
+	minv = 1;
+	minv.ShiftLimbsLeft((unsigned int)n);
+	minv -= inv;
+
+	one = 1;
+	one.ShiftLimbsLeft((unsigned int)n);
+	one = RemQuotient(one, m, NULL);
+	r2 = 1;
+	r2.ShiftLimbsLeft((unsigned int)(2 * n));
+	r2 = RemQuotient(r2, m, NULL);
+}
+
+pIntClass MontgomeryContext::ToMontgomery(const pIntClass& a) const
+{
+	if (a.IsNeg() || !(a < m))
+		return Multiply(RemQuotient(a, m, NULL), r2);
+	return Multiply(a, r2);
+}
+
+pIntClass MontgomeryContext::FromMontgomery(const pIntClass& a) const
+{
+	return Reduce(a);
+}
+
+pIntClass MontgomeryContext::Multiply(const pIntClass& a, const pIntClass& b) const
+{
+	if (n < MONTGOMERYLIMIT)
+		return SchoolbookMultiply(a, b);
+	return Reduce(a * b);
+}
+
+pIntClass MontgomeryContext::Square(const pIntClass& a) const
+{
+	return Multiply(a, a);
+}
+
+pIntClass MontgomeryContext::Reduce(const pIntClass& T) const
+{
+	pIntClass t(T);
+	if (n >= MONTGOMERYLIMIT) {
+		pIntClass q = pIntClass::Limbs(T, 0, n) * minv;
+		q = pIntClass::Limbs(q, 0, n);
+		t.AddMul(q, m);
+		t.ShiftLimbsRight((unsigned int)n);
+	}
+	else {
+		/* add u * m * B^i to make the low limb i zero, one limb at a time */
+		t.value.resize(2 * n + 1, 0);
+		for (size_t i = 0; i < n; i++) {
+			s64 u = ((s64)t.value[i] * mprime) % pIntClass::MODULUS;
+			s64 carry = 0;
+			size_t k = i;
+			for (size_t j = 0; j < n; j++, k++) {
+				s64 x = t.value[k] + u * m.value[j] + carry;
+				carry = x / pIntClass::MODULUS;
+				t.value[k] = (int)(x - carry * pIntClass::MODULUS);
+			}
+			for (; carry; k++) {
+				s64 x = t.value[k] + carry;
+				carry = x / pIntClass::MODULUS;
+				t.value[k] = (int)(x - carry * pIntClass::MODULUS);
+			}
+		}
+		t.value.erase(t.value.begin(), t.value.begin() + n);
+		t.normalize(t.value);
+	}
+	if (!(t < m)) t -= m;
+	return t;
+}
+
+/* the product and the reduction interleaved limb by limb (CIOS), t < 2m all the way */
+pIntClass MontgomeryContext::SchoolbookMultiply(const pIntClass& a, const pIntClass& b) const
+{
+	pIntClass t;
+	t.value.assign(n + 2, 0);
+	const int* av = a.value.data();
+	size_t na = a.value.size();
+	for (size_t i = 0; i < n; i++) {
+		s64 bi = (i < b.value.size()) ? b.value[i] : 0;
+		s64 carry = 0;
+		for (size_t j = 0; j < na; j++) {
+			s64 x = t.value[j] + av[j] * bi + carry;
+			carry = x / pIntClass::MODULUS;
+			t.value[j] = (int)(x - carry * pIntClass::MODULUS);
+		}
+		for (size_t j = na; carry; j++) {
+			s64 x = t.value[j] + carry;
+			carry = x / pIntClass::MODULUS;
+			t.value[j] = (int)(x - carry * pIntClass::MODULUS);
+		}
+
+		/* t = (t + u * m) / B */
+		s64 u = ((s64)t.value[0] * mprime) % pIntClass::MODULUS;
+		s64 x = t.value[0] + u * m.value[0];
+		carry = x / pIntClass::MODULUS;
+		for (size_t j = 1; j < n; j++) {
+			x = t.value[j] + u * m.value[j] + carry;
+			carry = x / pIntClass::MODULUS;
+			t.value[j - 1] = (int)(x - carry * pIntClass::MODULUS);
+		}
+		x = t.value[n] + carry;
+		carry = x / pIntClass::MODULUS;
+		t.value[n - 1] = (int)(x - carry * pIntClass::MODULUS);
+		t.value[n] = t.value[n + 1] + (int)carry;
+		t.value[n + 1] = 0;
+	}
+	t.normalize(t.value);
+	if (!(t < m)) t -= m;
+	return t;
+}
+
+pIntClass MontgomeryContext::Pow(const pIntClass& a, const pIntClass& e) const
+{
+	return FromMontgomery(WindowPow(*this, ToMontgomery(a), one, ExponentWords(e)));
+}
+
+
+BarrettContext::BarrettContext(const pIntClass& modulus) : valid(false), n(0), m(modulus)
+{
+	if (m.IsNeg()) m.ChSignBit();
+	if (m.IsZero()) {
+		std::cout << "divison by zero" << std::endl;
+		return;
+	}
+	valid = true;
+	n = m.value.size();
+	mu = pIntClass::Reciprocal(m, n);
+}
+
+pIntClass BarrettContext::Reduce(const pIntClass& x) const
+{
+	if (x.IsNeg() || x.value.size() > 2 * n)
+		return RemQuotient(x, m, NULL);
+	if (x < m)
+		return x;
+	if (n < BARRETTLIMIT)
+		return SchoolbookReduce(x);
+
+	pIntClass q(x);
+	q.ShiftLimbsRight((unsigned int)(n - 1));
+	q *= mu;
+	q.ShiftLimbsRight((unsigned int)(n + 1));
+
+	pIntClass r(x);
+	r.SubMul(q, m);
+	while (!(r < m)) r -= m;
+	return r;
+}
+
+/*
+*   Only the columns n - 1 and up of floor(x / B^(n-1)) * mu are computed, the dropped columns are worth
+*   less than n * B^n, so q is at most one more below.  r < 4m < B^(n+1) only needs the low n + 1 limbs.
+*/
+pIntClass BarrettContext::SchoolbookReduce(const pIntClass& x) const
+{
+	const s64 B = pIntClass::MODULUS;
+	const int* q1 = x.value.data() + (n - 1);
+	size_t nq1 = x.value.size() - (n - 1);
+	const int* mv = mu.value.data();
+	size_t nmu = mu.value.size();
+
+	s64 acc[BARRETTLIMIT + 8] = { 0 };   // column n - 1 + k in acc[k]
+	for (size_t i = 0; i < nq1; i++) {
+		s64 carry = 0;
+		size_t k = 0;
+		for (size_t j = (i < n - 1) ? n - 1 - i : 0; j < nmu; j++) {
+			k = i + j - (n - 1);
+			s64 t = acc[k] + q1[i] * (s64)mv[j] + carry;
+			carry = t / B;
+			acc[k] = t - carry * B;
+		}
+		for (k++; carry; k++) {
+			s64 t = acc[k] + carry;
+			carry = t / B;
+			acc[k] = t - carry * B;
+		}
+	}
+	const s64* q = acc + 2;
+	size_t nq = nq1 + nmu - 1 - (n + 1) + 1;
+
+	/* r = x - q * m mod B^(n+1) */
+	s64 r[BARRETTLIMIT + 2];
+	for (size_t k = 0; k <= n; k++) r[k] = (k < x.value.size()) ? x.value[k] : 0;
+	for (size_t i = 0; i < nq && i <= n; i++) {
+		s64 carry = 0;
+		for (size_t j = 0; j < n && i + j <= n; j++) {
+			s64 t = r[i + j] - q[i] * m.value[j] + carry;
+			carry = t / B;
+			t -= carry * B;
+			if (t < 0) { t += B; carry--; }
+			r[i + j] = t;
+		}
+		for (size_t k = i + n; k <= n && carry; k++) {
+			s64 t = r[k] + carry;
+			carry = t / B;
+			t -= carry * B;
+			if (t < 0) { t += B; carry--; }
+			r[k] = t;
+		}
+	}
+
+	pIntClass res;
+	res.value.assign(r, r + n + 1);
+	res.normalize(res.value);
+	while (!(res < m)) res -= m;
+	return res;
+}
+
+pIntClass BarrettContext::Multiply(const pIntClass& a, const pIntClass& b) const
+{
+	pIntClass t;
+	t.AddMul(a, b);
+	return Reduce(t);
+}
+
+pIntClass BarrettContext::Square(const pIntClass& a) const
+{
+	return Multiply(a, a);
+}
+
+pIntClass BarrettContext::Pow(const pIntClass& a, const pIntClass& e) const
+{
+	return WindowPow(*this, Reduce(a), Reduce(pIntClass(1)), ExponentWords(e));
+}
+
+
+FixedBasePow::FixedBasePow(const pIntClass& base, const pIntClass& modulus, size_t maxbits) : ctx(modulus), h(1), a(1)
+{
+	if (!ctx.IsValid()) return;
+	g = ctx.Reduce(base);
+
+	/* the table costs 2^h multiplications and (h - 1) * a squarings, once */
+	if (maxbits > 2048) h = 8;
+	else if (maxbits > 256) h = 6;
+	else if (maxbits > 32) h = 4;
+	else h = 2;
+	a = std::max((maxbits + h - 1) / h, (size_t)1);
+
+	table.resize((size_t)1 << h);
+	table[0] = ctx.Reduce(pIntClass(1));
+	pIntClass gi = g;                              // g^(2^(i*a))
+	for (size_t i = 0; i < h; i++) {
+		if (i > 0)
+			for (size_t k = 0; k < a; k++) gi = ctx.Square(gi);
+		size_t top = (size_t)1 << i;
+		for (size_t j = 0; j < top; j++) table[top + j] = ctx.Multiply(table[j], gi);
+	}
+}
+
+pIntClass FixedBasePow::Pow(const pIntClass& e) const
+{
+	if (!ctx.IsValid()) return pIntClass();
+	std::vector<uint32_t> words = ExponentWords(e);
+	auto bit = [&words](size_t k) { return (k < 30 * words.size()) ? (words[k / 30] >> (k % 30)) & 1 : 0; };
+	size_t bits = 30 * words.size();
+	while (bits > 0 && !bit(bits - 1)) bits--;
+	if (bits > h * a) return ctx.Pow(g, e);
+
+	pIntClass result = table[0];
+	bool started = false;
+	for (size_t k = a; k > 0; k--) {
+		if (started) result = ctx.Square(result);
+		size_t j = 0;
+		for (size_t i = h; i > 0; i--) j = 2 * j + bit((i - 1) * a + k - 1);
+		if (j) {
+			result = started ? ctx.Multiply(result, table[j]) : table[j];
+			started = true;
+		}
+	}
+	return result;
+}
+
+
+ModReducer::Form ModReducer::Detect(const pIntClass& modulus, unsigned int& k, int& c)
+{
+	k = 0;
+	c = 0;
+	size_t n = modulus.value.size();
+	if (n < SPECIALFORMLIMIT) return GENERIC;
+	int top = std::abs(modulus.value.back());
+	unsigned int digits = 9 * (unsigned int)(n - 1);
+	for (int t = top; t > 0; t /= 10) digits++;
+
+	pIntClass m(modulus);
+	if (m.IsNeg()) m.ChSignBit();
+	pIntClass t(1);
+	t.MulPow10(digits);
+	t -= m;                                   // 10^k - m
+	if (t.value.size() == 1 && t.value[0] > 0) {
+		k = digits;
+		c = t.value[0];
+		return DECIMALMINUS;
+	}
+	t = 1;
+	t.MulPow10(digits - 1);
+	t -= m;                                   // -(m - 10^k)
+	if (t.value.size() == 1 && t.value[0] < 0) {
+		k = digits - 1;
+		c = -t.value[0];
+		return DECIMALPLUS;
+	}
+	return GENERIC;
+}
+
+ModReducer::ModReducer(const pIntClass& modulus) : valid(false), form(GENERIC), k(0), c(0), m(modulus), barrett(1)
+{
+	if (m.IsNeg()) m.ChSignBit();
+	if (m.IsZero()) {
+		std::cout << "divison by zero" << std::endl;
+		return;
+	}
+	valid = true;
+	form = Detect(m, k, c);
+	if (form == GENERIC) barrett = BarrettContext(m);
+}
+
+ModReducer::ModReducer(const pIntClass& modulus, Form detected, unsigned int detectedk, int detectedc) : valid(false), form(detected), k(detectedk), c(detectedc), m(modulus), barrett(1)
+{
+	if (m.IsNeg()) m.ChSignBit();
+	if (m.IsZero()) {
+		std::cout << "divison by zero" << std::endl;
+		return;
+	}
+	valid = true;
+	if (form == GENERIC) barrett = BarrettContext(m);
+}
+
+pIntClass ModReducer::Reduce(const pIntClass& x) const
+{
+	if (form == GENERIC)
+		return barrett.Reduce(x);
+
+	/*
+	*   10^k = +-c mod m, so x = hi * 10^k + lo is replaced by lo +- c * hi, which has about
+	*   k digits less. With k = 9q + r, hi[i] is made of the digits of x[q + i] and x[q + i + 1],
+	*   the new limb i is written after the last read of x[i], so it is done in place.
+	*/
+	const s64 B = pIntClass::MODULUS;
+	const size_t q = k / 9;
+	s64 p = 1;
+	for (unsigned int i = 0; i < k % 9; i++) p *= 10;
+	const s64 sc = (form == DECIMALMINUS) ? c : -(s64)c;
+
+	pIntClass t(x);
+	pIntVector& v = t.value;
+	while (v.size() > q + 1 || (v.size() == q + 1 && std::abs(v[q]) >= p)) {
+		size_t n = v.size();
+		size_t nh = n - q;
+		size_t len = std::max(q + 1, nh);
+		s64 carry = 0;
+		for (size_t i = 0; i < len; i++) {
+			s64 lo = (i < q) ? v[i] : ((i == q) ? v[q] % p : 0);
+			s64 hi = 0;
+			if (i < nh) {
+				hi = v[q + i] / p;
+				if (q + i + 1 < n) hi += (v[q + i + 1] % p) * (B / p);
+			}
+			s64 w = lo + sc * hi + carry;
+			carry = w / B;
+			v[i] = (int)(w - carry * B);
+		}
+		v.resize(len);
+		if (carry) v.push_back((int)carry);
+		t.normalize(v);
+	}
+	while (t.IsNeg()) t += m;
+	while (!(t < m)) t -= m;
+	return t;
+}
+
+CrtContext::CrtContext(const pIntClass& p, const pIntClass& q) : valid(false), primes(true)
+{
+	pIntClass factors[2] = { p, q };
+	Init(factors, 2);
+}
+
+CrtContext::CrtContext(const pIntClass* factors, size_t count, bool _primes) : valid(false), primes(_primes)
+{
+	Init(factors, count);
+}
+
+void CrtContext::Init(const pIntClass* factors, size_t count)
+{
+	if (count == 0) {
+		std::cout << "CrtContext: no factors" << std::endl;
+		return;
+	}
+	n = 1;
+	for (size_t i = 0; i < count; i++) {
+		pIntClass f = factors[i];
+		if (f.IsNeg()) f.ChSignBit();
+		if (f.IsZero() || f.IsOne()) {
+			std::cout << "CrtContext: the factors must be > 1" << std::endl;
+			return;
+		}
+		pIntClass inverse;
+		if (!ModInverse(n, f, inverse)) {
+			std::cout << "CrtContext: the factors are not coprime" << std::endl;
+			return;
+		}
+		m.push_back(f);
+		prefix.push_back(n);
+		inverses.push_back(inverse);
+		n *= f;
+
+		uint32_t last = f.ModInt(10);
+		context.push_back(-1);
+		if ((last & 1) && last != 5) {
+			context.back() = (int)montgomery.size();
+			montgomery.push_back(MontgomeryContext(f));
+		}
+	}
+	valid = true;
+}
+
+/* a^e mod m[i] */
+pIntClass CrtContext::PowFactor(const pIntClass& a, const pIntClass& e, size_t i) const
+{
+	pIntClass r = RemQuotient(a, m[i], NULL);
+	pIntClass f = e;
+	if (primes) {
+		/* a^e = a^(e mod (p - 1)) mod p unless p divides a */
+		if (r.IsZero()) return e.IsZero() ? pIntClass(1) : r;
+		pIntClass p1 = m[i];
+		p1 -= 1;
+		f = RemQuotient(e, p1, NULL);
+	}
+	if (context[i] < 0) return modpow(r, f, m[i]);
+	return montgomery[context[i]].Pow(r, f);
+}
+
+pIntClass CrtContext::Pow(const pIntClass& a, const pIntClass& e, int threads) const
+{
+	if (!valid) return pIntClass();
+	if (e.IsNeg()) {
+		std::cout << "CrtContext: negative exponent" << std::endl;
+		return pIntClass();
+	}
+
+	std::vector<pIntClass> r(m.size());
+	if (threads > 1 && m.size() > 1 && m[0].Size() >= CRTTHREADLIMIT) {
+		/* the last factor on this thread, the workers keep their results in their own storage (their
+		   memory resource) and they are copied into r on this thread after the join */
+		std::vector<std::thread> workers;
+		size_t workercount = std::min((size_t)threads, m.size()) - 1;
+		std::vector<std::vector<pIntClass> > results(workercount);
+		for (size_t t = 0; t < workercount; t++)
+			workers.emplace_back([&, t]() {
+				for (size_t i = t; i < m.size() - 1; i += workercount) results[t].push_back(PowFactor(a, e, i));
+			});
+		r.back() = PowFactor(a, e, m.size() - 1);
+		for (auto& w : workers) w.join();
+		for (size_t t = 0; t < workercount; t++)
+			for (size_t j = 0; j < results[t].size(); j++) r[t + j * workercount] = results[t][j];
+	}
+	else
+		for (size_t i = 0; i < m.size(); i++) r[i] = PowFactor(a, e, i);
+
+	return Combine(r.data());
+}
+
+pIntClass CrtContext::Combine(const pIntClass* residues) const
+{
+	if (!valid) return pIntClass();
+	pIntClass x = RemQuotient(residues[0], m[0], NULL);
+	for (size_t i = 1; i < m.size(); i++) {
+		pIntClass t = residues[i] - x;
+		t = RemQuotient(t, m[i], NULL);
+		t = RemQuotient(t * inverses[i], m[i], NULL);
+		x += prefix[i] * t;
+	}
+	return x;
+}
+
+pIntClass MultiPow(const pIntClass* bases, const pIntClass* exponents, size_t count, const pIntClass& mod)
+{
+	pIntClass m = mod;
+	if (m.IsNeg()) m.ChSignBit();
+	std::vector<std::vector<uint32_t> > words(count);
+	for (size_t i = 0; i < count; i++) words[i] = ExponentWords(exponents[i]);
+	std::vector<pIntClass> x(count);
+
+	uint32_t last = m.ModInt(10);
+	if (!m.IsOne() && (last & 1) && last != 5) {
+		MontgomeryContext ctx(m);
+		for (size_t i = 0; i < count; i++) x[i] = ctx.ToMontgomery(bases[i]);
+		return ctx.FromMontgomery(InterleavedPow(ctx, x, ctx.One(), words));
+	}
+
+	BarrettContext ctx(m);
+	if (!ctx.IsValid()) return pIntClass();
+	for (size_t i = 0; i < count; i++) x[i] = ctx.Reduce(bases[i]);
+	return InterleavedPow(ctx, x, ctx.Reduce(pIntClass(1)), words);
+}
+
+
+pIntClass ModReducer::Multiply(const pIntClass& a, const pIntClass& b) const
+{
+	pIntClass t;
+	t.AddMul(a, b);
+	return Reduce(t);
+}
+
+pIntClass ModReducer::Square(const pIntClass& a) const
+{
+	return Multiply(a, a);
+}
+
+pIntClass ModReducer::Pow(const pIntClass& a, const pIntClass& e) const
+{
+	if (form == GENERIC)
+		return barrett.Pow(a, e);
+	return WindowPow(*this, Reduce(a), Reduce(pIntClass(1)), ExponentWords(e));
+}
@@ -0,0 +1,213 @@
+#pragma once
+/*
+Copyright   2024 Claus Vind - Andreasen
+
+This program is free software; you can redistribute it and /or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU General Public License for more details.
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111 - 1307 USA
+This General Public License does not permit incorporating your program into proprietary programs.If your program is a subroutine library, you may consider it more useful to permit linking proprietary applications with the library.
+If this is what you want to do, use the GNU Library General Public License instead of this License.
+*/
+
+#include "pIntClass.h"
+
+/*
+*   Montgomery arithmetic modulo a fixed m coprime to MODULUS (odd and not divisible by 5).
+*
+*   With R = MODULUS^n, n the number of limbs in m, a number x is kept as x * R mod m,
+*   then Multiply(aR, bR) = a * b * R mod m is computed without any division:
+*   the product T is made divisible by R by adding a multiple of m and shifted down.
+*
+*   Below MONTGOMERYLIMIT limbs the multiplication and reduction are interleaved limb
+*   by limb (schoolbook), above it the product and the reduction use the library
+*   multiplication (Karatsuba):  Reduce(T) = (T + (T * m' mod R) * m) / R,  m' = -1/m mod R.
+*   The schoolbook variant does fewer passes over memory and wins up to about 180 limbs.
+*/
+#define MONTGOMERYLIMIT 180
+
+class MontgomeryContext
+{
+public:
+
+	MontgomeryContext(const pIntClass& modulus);
+
+	bool IsValid() const { return valid; }
+	const pIntClass& Modulus() const { return m; }
+	const pIntClass& One() const { return one; }   // R mod m, 1 in Montgomery form
+
+	pIntClass ToMontgomery(const pIntClass& a) const;    // a * R mod m, any a
+	pIntClass FromMontgomery(const pIntClass& a) const;  // a / R mod m
+
+	/* a, b in Montgomery form, 0 <= a, b < m */
+	pIntClass Multiply(const pIntClass& a, const pIntClass& b) const;
+	pIntClass Square(const pIntClass& a) const;
+	pIntClass Reduce(const pIntClass& T) const;          // T / R mod m, 0 <= T < m * R
+
+	/* a^e mod m in normal form */
+	pIntClass Pow(const pIntClass& a, const pIntClass& e) const;
+
+private:
+	bool valid;
+	size_t n;
+	int mprime;             // -1/m mod MODULUS
+	pIntClass m;
+	pIntClass minv;         // -1/m mod R
+	pIntClass one;          // R mod m
+	pIntClass r2;           // R^2 mod m
+
+	pIntClass SchoolbookMultiply(const pIntClass& a, const pIntClass& b) const;
+};
+
+
+/*
+*   Barrett reduction modulo a fixed m != 0, no condition on the digits of m.
+*
+*   With n the number of limbs in m and mu = floor(B^2n / m) computed once, x < B^2n is reduced by
+*       q = floor(floor(x / B^(n-1)) * mu / B^(n+1)),  r = x - q * m
+*   q is at most 2 below the true quotient, so a couple of subtractions finish the job.
+*   Operands stay in normal form, Reduce() falls back to RemQuotient for x < 0 or x >= B^2n.
+*
+*   Below BARRETTLIMIT limbs only the needed halves of the two products are computed (schoolbook),
+*   above it the full products are done with the library multiplication.
+*/
+#define BARRETTLIMIT 200
+
+class BarrettContext
+{
+public:
+
+	BarrettContext(const pIntClass& modulus);
+
+	bool IsValid() const { return valid; }
+	const pIntClass& Modulus() const { return m; }
+
+	pIntClass Reduce(const pIntClass& x) const;                        // x mod |m|, 0 <= result < |m|
+	pIntClass Multiply(const pIntClass& a, const pIntClass& b) const;  // a * b mod |m|
+	pIntClass Square(const pIntClass& a) const;
+
+	/* a^|e| mod |m| */
+	pIntClass Pow(const pIntClass& a, const pIntClass& e) const;
+
+private:
+	bool valid;
+	size_t n;
+	pIntClass m;
+	pIntClass mu;           // floor(B^2n / m)
+
+	pIntClass SchoolbookReduce(const pIntClass& x) const;
+};
+
+
+/*
+*   g^e mod m for a fixed base g and many exponents (Lim-Lee comb, one row per block).
+*
+*   An exponent of up to t bits is cut into h blocks of a = ceil(t / h) bits. The table holds
+*   G[j] = prod g^(2^(i*a)) over the bits i set in j, 0 <= j < 2^h, then
+*       g^e = prod over k = a-1 .. 0 of ( R^2 * G[bit k of every block] )
+*   which is a squarings and at most a multiplications instead of t squarings.
+*   Longer exponents than t are handled by BarrettContext::Pow.
+*/
+class FixedBasePow
+{
+public:
+
+	FixedBasePow(const pIntClass& base, const pIntClass& modulus, size_t maxbits);
+
+	bool IsValid() const { return ctx.IsValid(); }
+	pIntClass Pow(const pIntClass& e) const;      // g^|e| mod |m|
+
+private:
+	BarrettContext ctx;
+	pIntClass g;
+	size_t h;
+	size_t a;
+	std::vector<pIntClass> table;
+};
+
+
+/*
+*   a^e mod n for n = m[0] * m[1] * ... with known pairwise coprime factors, e >= 0.
+*
+*   The powers r[i] = a^e mod m[i] are independent (one thread each when asked for and the
+*   factors have at least CRTTHREADLIMIT limbs) and are recombined with Garner's algorithm
+*       x = r[0],  x += (m[0] ... m[i-1]) * ((r[i] - x) * (m[0] ... m[i-1])^-1 mod m[i])
+*   When the factors are primes the exponent is first reduced mod m[i] - 1, for two factors
+*   of half the size that is about 4 times less work than a^e mod n.
+*/
+#define CRTTHREADLIMIT 20
+
+class CrtContext
+{
+public:
+
+	CrtContext(const pIntClass& p, const pIntClass& q);                       // distinct primes
+	CrtContext(const pIntClass* factors, size_t count, bool primes = true);   // pairwise coprime
+
+	bool IsValid() const { return valid; }
+	const pIntClass& Modulus() const { return n; }
+
+	pIntClass Pow(const pIntClass& a, const pIntClass& e, int threads = 1) const;
+	pIntClass Combine(const pIntClass* residues) const;   // the x mod n with x = residues[i] mod m[i]
+
+private:
+	bool valid;
+	bool primes;
+	pIntClass n;
+	std::vector<pIntClass> m;
+	std::vector<pIntClass> prefix;      // m[0] ... m[i-1]
+	std::vector<pIntClass> inverses;    // (m[0] ... m[i-1])^-1 mod m[i]
+	std::vector<MontgomeryContext> montgomery;
+	std::vector<int> context;           // the Montgomery context of m[i], -1 if m[i] is not coprime to 10
+
+	void Init(const pIntClass* factors, size_t count);
+	pIntClass PowFactor(const pIntClass& a, const pIntClass& e, size_t i) const;
+};
+
+
+/* prod bases[i]^|exponents[i]| mod |m| with one shared squaring chain */
+pIntClass MultiPow(const pIntClass* bases, const pIntClass* exponents, size_t count, const pIntClass& mod);
+
+
+/*
+*   Reduction modulo m by the cheapest method for the form of m, detected from its digits
+*
+*       10^k - c, 10^k + c, 0 < c < MODULUS:   x = hi * 10^k + lo = lo + c * hi  (resp. lo - c * hi) mod m,
+*                                              a limb / digit split and a multiplication by an int
+*       anything else:                         Barrett
+*
+*   The binary special forms (2^p - 1, 2^k - c, the NIST primes) have no cheap split in the decimal
+*   radix: x / 2^k takes k / 29 passes of short divisions, measured 5-7x slower than Barrett, so
+*   they are left to Barrett (and Montgomery in modpow).  Below SPECIALFORMLIMIT limbs Barrett
+*   is as fast as the decimal split.
+*/
+#define SPECIALFORMLIMIT 12
+
+class ModReducer
+{
+public:
+
+	enum Form { GENERIC, DECIMALMINUS, DECIMALPLUS };
+
+	ModReducer(const pIntClass& modulus);
+	ModReducer(const pIntClass& modulus, Form form, unsigned int k, int c);   // form, k and c from Detect(modulus, k, c)
+
+	/* the form of |m|, m = 10^k - c or 10^k + c, GENERIC for small or other moduli */
+	static Form Detect(const pIntClass& m, unsigned int& k, int& c);
+
+	bool IsValid() const { return valid; }
+	Form GetForm() const { return form; }
+	const pIntClass& Modulus() const { return m; }
+
+	pIntClass Reduce(const pIntClass& x) const;                        // x mod |m|, 0 <= result < |m|
+	pIntClass Multiply(const pIntClass& a, const pIntClass& b) const;  // a * b mod |m|
+	pIntClass Square(const pIntClass& a) const;
+	pIntClass Pow(const pIntClass& a, const pIntClass& e) const;      // a^|e| mod |m|
+
+private:
+	bool valid;
+	Form form;
+	unsigned int k;
+	int c;
+	pIntClass m;
+	BarrettContext barrett;
+};
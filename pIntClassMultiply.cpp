@@ -49,37 +49,165 @@ pIntClass pIntClass::operator*=(const pIntClass& rhs)
 		return SchoenhageStrassenMultiplication(rhs);
 	else
 #endif
+	if (std::min(value.size(), rhs.value.size()) >= KARATSUBALIMIT)
+		return KaratsubaMultiplication(rhs);
+	else
 		return SchoolbookMultiplication(rhs);
 
 }
 
+/*
+*   Karatsuba multiplication works on the magnitudes, as plain arrays of digits in [0, MODULUS[.
+*   With a = a1 * B^m + a0 and b = b1 * B^m + b0
+*
+*      a * b = a1 * b1 * B^2m + ((a0 + a1) * (b0 + b1) - a0 * b0 - a1 * b1) * B^m + a0 * b0
+*
+*   so three half size products replace four. All partial results are non-negative
+*   and no larger than the product, so adding them up in r never carries past r[na + nb - 1].
+*/
+
+/* r[0 .. rn - 1] += a, returns the carry out of r[rn - 1] */
+static int AddDigits(int* r, size_t rn, const int* a, size_t an)
+{
+	while (an && (a[an - 1] == 0)) an--;
+	int carry = 0;
+	size_t i = 0;
+	for (; i < an; i++) {
+		int t = r[i] + a[i] + carry;
+		carry = (t >= pIntClass::MODULUS) ? 1 : 0;
+		r[i] = t - carry * pIntClass::MODULUS;
+	}
+	for (; carry && (i < rn); i++) {
+		int t = r[i] + carry;
+		carry = (t >= pIntClass::MODULUS) ? 1 : 0;
+		r[i] = t - carry * pIntClass::MODULUS;
+	}
+	return carry;
+}
+
+/* r[0 .. rn - 1] -= a, a <= r */
+static void SubDigits(int* r, size_t rn, const int* a, size_t an)
+{
+	while (an && (a[an - 1] == 0)) an--;
+	int borrow = 0;
+	size_t i = 0;
+	for (; i < an; i++) {
+		int t = r[i] - a[i] - borrow;
+		borrow = (t < 0) ? 1 : 0;
+		r[i] = t + borrow * pIntClass::MODULUS;
+	}
+	for (; borrow && (i < rn); i++) {
+		int t = r[i] - borrow;
+		borrow = (t < 0) ? 1 : 0;
+		r[i] = t + borrow * pIntClass::MODULUS;
+	}
+}
+
+/* r[0 .. na + nb - 1] = a * b, r must be 0 on entry */
+void pIntClass::KaratsubaMul(const int* a, size_t na, const int* b, size_t nb, int* r)
+{
+	if (na < nb) { std::swap(a, b); std::swap(na, nb); }
+	if (nb == 0) return;
+
+	if (nb < KARATSUBALIMIT) {
+		for (size_t j = 0; j < nb; j++) {
+			s64 multiplier = b[j];
+			s64 carry = 0;
+			size_t k = j;
+			for (size_t ix = 0; ix < na; ix++, k++) {
+				s64 t = r[k] + multiplier * a[ix] + carry;
+				carry = t / MODULUS;
+				r[k] = (int)(t - carry * MODULUS);
+			}
+			for (; carry; k++) {
+				s64 t = r[k] + carry;
+				carry = t / MODULUS;
+				r[k] = (int)(t - carry * MODULUS);
+			}
+		}
+		return;
+	}
+
+	/* a much longer than b, multiply b by slices of a */
+	if (nb <= na / 2) {
+		pIntVector t(2 * nb, 0, Allocator());
+		for (size_t i = 0; i < na; i += nb) {
+			size_t slice = std::min(nb, na - i);
+			std::fill(t.begin(), t.end(), 0);
+			KaratsubaMul(a + i, slice, b, nb, t.data());
+			AddDigits(r + i, na + nb - i, t.data(), slice + nb);
+		}
+		return;
+	}
+
+	size_t m = (na + 1) / 2;
+	size_t nb0 = std::min(m, nb);
+	pIntVector z0(2 * m, 0, Allocator());
+	pIntVector z2(na + nb - m, 0, Allocator());
+	pIntVector sa(m + 1, 0, Allocator());
+	pIntVector sb(m + 1, 0, Allocator());
+	pIntVector z1(2 * m + 2, 0, Allocator());
+
+	KaratsubaMul(a, m, b, nb0, z0.data());
+	KaratsubaMul(a + m, na - m, b + nb0, nb - nb0, z2.data());
+
+	std::copy(a, a + m, sa.begin());
+	sa[m] = AddDigits(sa.data(), m, a + m, na - m);
+	std::copy(b, b + nb0, sb.begin());
+	sb[m] = AddDigits(sb.data(), m, b + nb0, nb - nb0);
+	KaratsubaMul(sa.data(), m + 1, sb.data(), m + 1, z1.data());
+	SubDigits(z1.data(), z1.size(), z0.data(), z0.size());
+	SubDigits(z1.data(), z1.size(), z2.data(), z2.size());
+
+	AddDigits(r, na + nb, z0.data(), z0.size());
+	AddDigits(r + m, na + nb - m, z1.data(), z1.size());
+	AddDigits(r + 2 * m, na + nb - 2 * m, z2.data(), z2.size());
+}
+
+pIntClass pIntClass::KaratsubaMultiplication(const pIntClass& rhs)
+{
+	if ((value.size() == 0) || (rhs.value.size() == 0)) {
+		value.clear();
+		return *this;
+	}
+	int mysign = (value.back() >= 0) ? 1 : -1;
+	int rhsign = (rhs.value.back() >= 0) ? 1 : -1;
+
+	pIntVector a(value, Allocator());
+	pIntVector b(rhs.value, Allocator());
+	for (size_t i = 0; i < a.size(); i++) a[i] *= mysign;
+	for (size_t i = 0; i < b.size(); i++) b[i] *= rhsign;
+
+	value.assign(a.size() + b.size(), 0);
+	KaratsubaMul(a.data(), a.size(), b.data(), b.size(), value.data());
+	if (mysign != rhsign)
+		for (size_t i = 0; i < value.size(); i++) value[i] = -value[i];
+	normalize(value);
+	return *this;
+}
+
 pIntClass pIntClass::SchoolbookMultiplication(const pIntClass& rhs)
 {
-	std::vector<s64> buffer;
-	std::vector<int> acc;
+	pIntVector acc(Allocator());
 	if (value.size() && rhs.value.size()) {
 		int mysign =     (value.back() >= 0) ? 1 : -1;
 		int rhsign = (rhs.value.back() >= 0) ? 1 : -1;
 
-		buffer.reserve(value.size() + rhs.value.size() + 1);
 		acc.reserve(value.size() + rhs.value.size() + 1);
 
 		for (int i1 = 0; i1 < value.size() + rhs.value.size() + 1; i1++) {
 			acc.push_back(0);
-			buffer.push_back(0);
 		}
 
 
 		for (int j = 0; j < rhs.value.size(); j++) {
 			s64 multiplier = (s64)( (rhsign > 0) ? rhs.value[j] : -rhs.value[j]);
-			for (int ix = 0; ix < value.size(); ix++)  
-				buffer[ix] = ((s64)( (mysign > 0) ? value[ix] : -value[ix])) * multiplier;
 			s64 carry = 0;
 			for (int cx = 0; cx < value.size(); cx++) {
-				buffer[cx] = buffer[cx] + acc[j+cx]+  carry;
-				carry = buffer[cx] / MODULUS;
-				acc[j + cx] = buffer[cx] % MODULUS;
-				buffer[cx] = 0;
+				s64 t = ((s64)( (mysign > 0) ? value[cx] : -value[cx])) * multiplier;
+				t = t + acc[j+cx]+  carry;
+				carry = t / MODULUS;
+				acc[j + cx] = t % MODULUS;
 			}
 			if (carry) acc[j + value.size()] = (int) carry;
 		}
@@ -90,7 +218,6 @@ pIntClass pIntClass::SchoolbookMultiplication(const pIntClass& rhs)
 		if (( (mysign < 0) && (rhsign > 0)) ||	((mysign > 0) && (rhsign < 0)))
 			for (int ix = 0; ix < value.size(); ix++) value[ix] = -value[ix];
 
-		buffer.clear();
 		acc.clear();
 	}
 	else
@@ -99,6 +226,105 @@ pIntClass pIntClass::SchoolbookMultiplication(const pIntClass& rhs)
 	return *this;
 }
 
+/*
+*   this += sign * a * b, the partial products are added straight into value[]
+*   with a signed carry, so the digits end up in ]-MODULUS, MODULUS[ but
+*   possibly with mixed signs. The caller must normalize().
+*/
+void pIntClass::MulAccumulate(const pIntClass& a, const pIntClass& b, int sign)
+{
+	if ((a.value.size() == 0) || (b.value.size() == 0)) return;
+
+#ifdef SSLIMIT
+	/* the operands are loaded into the FFT buffers before value[] is touched,
+	   if no FFT length is found we fall back to the loop below */
+	if ((a.value.size() + b.value.size() >= SSLIMIT) && SchoenhageStrassenAccumulate(a, b, sign, false))
+		return;
+#endif
+	if (std::min(a.value.size(), b.value.size()) >= KARATSUBALIMIT) {
+		pIntClass product(a);
+		product.KaratsubaMultiplication(b);
+		MulAccumulate(product, 1, sign);
+		return;
+	}
+	if ((this == &a) || (this == &b)) {
+		pIntClass temp(*this);
+		MulAccumulate((this == &a) ? temp : a, (this == &b) ? temp : b, sign);
+		return;
+	}
+	if (value.size() < a.value.size() + b.value.size())
+		value.resize(a.value.size() + b.value.size(), 0);
+
+	for (size_t j = 0; j < b.value.size(); j++) {
+		s64 multiplier = (sign < 0) ? -(s64)b.value[j] : (s64)b.value[j];
+		s64 carry = 0;
+		size_t k = j;
+		for (size_t ix = 0; ix < a.value.size(); ix++, k++) {
+			s64 t = value[k] + multiplier * a.value[ix] + carry;
+			carry = t / MODULUS;
+			value[k] = (int)(t - carry * MODULUS);
+		}
+		for (; carry; k++) {
+			if (k == value.size()) value.push_back(0);
+			s64 t = value[k] + carry;
+			carry = t / MODULUS;
+			value[k] = (int)(t - carry * MODULUS);
+		}
+	}
+}
+
+pIntClass& pIntClass::AddMul(const pIntClass& a, const pIntClass& b)
+{
+	MulAccumulate(a, b, 1);
+	normalize(value);
+	return *this;
+}
+
+pIntClass& pIntClass::SubMul(const pIntClass& a, const pIntClass& b)
+{
+	MulAccumulate(a, b, -1);
+	normalize(value);
+	return *this;
+}
+
+pIntClass& pIntClass::AddMul(const pIntClass& a, const int b)
+{
+	MulAccumulate(a, b, 1);
+	normalize(value);
+	return *this;
+}
+
+pIntClass& pIntClass::SubMul(const pIntClass& a, const int b)
+{
+	MulAccumulate(a, b, -1);
+	normalize(value);
+	return *this;
+}
+
+/* this += sign * a * k, a may be this */
+void pIntClass::MulAccumulate(const pIntClass& a, const int k, int sign)
+{
+	if ((a.value.size() == 0) || (k == 0)) return;
+
+	s64 multiplier = (sign < 0) ? -(s64)k : (s64)k;
+	size_t sz = a.value.size();
+	if (value.size() < sz) value.resize(sz, 0);
+
+	s64 carry = 0;
+	size_t i = 0;
+	for (; i < sz; i++) {
+		s64 t = value[i] + multiplier * a.value[i] + carry;
+		carry = t / MODULUS;
+		value[i] = (int)(t - carry * MODULUS);
+	}
+	for (; carry; i++) {
+		if (i == value.size()) value.push_back(0);
+		s64 t = value[i] + carry;
+		carry = t / MODULUS;
+		value[i] = (int)(t - carry * MODULUS);
+	}
+}
+
 
 
 
@@ -113,73 +339,71 @@ void pIntClass::Scale(int scale)
 		return; 
 	} //scaling with -1 -> change sign
 	else {
+		/* all digits have the same sign, so a signed carry keeps the number normalized */
 		s64 carry = 0;
-		s64 t = 0;
-		s64 s = scale;
-		int sign = (value.back()>= 0) ? 1 : -1 ;  // save sign
-
-		if (s < 0) {
-			s = -1 * s;
-			sign = -sign ;
-		}
-
-		for (int i = 0; i < value.size(); i++)
+		for (size_t i = 0; i < value.size(); i++)
 		{
-			t = (s64)value[i];
-			t *= s;
-			t += carry;
-			carry = 0;
-			if (t >= MODULUS) {
-				carry = (int)(t / MODULUS);
-				t = t % MODULUS;
-			}
-			value[i] = (int)t;
+			s64 t = (s64)scale * value[i] + carry;
+			carry = t / MODULUS;
+			value[i] = (int)(t - carry * MODULUS);
 		}
-
 		while (carry) {
-			value.push_back(carry % MODULUS);
+			value.push_back((int)(carry % MODULUS));
 			carry = carry / MODULUS;
 		}
-		if(sign == -1)
-			for (size_t ix = 0; ix < value.size(); ix++)
-				value[ix] = -value[ix];
-
-		normalize(value);
 		return ;
 	}
 }
 
 
 
+/*
+*   value[] is multiplied or divided by 2^bits, bits <= SHIFTBITS, in one pass with a
+*   single s64 carry. 2^29 * MODULUS still fits in a s64, so a shift by k bits costs
+*   k / SHIFTBITS passes instead of k. The digits all have the same sign, so
+*   negative numbers need no sign flips, and >>= truncates towards 0.
+*/
+#define SHIFTBITS 29
+
+void pIntClass::ShiftLeftBits(unsigned int bits)
+{
+	s64 multiplier = ((s64)1) << bits;
+	s64 carry = 0;
+	for (size_t i = 0; i < value.size(); i++)
+	{
+		s64 t = multiplier * value[i] + carry;
+		carry = t / MODULUS;
+		value[i] = (int)(t - carry * MODULUS);
+	}
+	if (carry) value.push_back((int)carry);
+}
+
+int pIntClass::ShiftRightBits(unsigned int bits)
+{
+	return DivSmall(1 << bits);
+}
+
+/* this /= divisor, 0 < divisor <= MODULUS, returns the remainder with the sign of this */
+int pIntClass::DivSmall(int divisor)
+{
+	s64 rem = 0;
+	for (size_t i = value.size(); i > 0; i--)
+	{
+		s64 t = rem * MODULUS + value[i - 1];
+		value[i - 1] = (int)(t / divisor);
+		rem = t % divisor;
+	}
+	while (value.size() && (value.back() == 0)) value.pop_back();
+	return (int)rem;
+}
+
 pIntClass& pIntClass::operator<<=(const unsigned int shift)
 {
 	unsigned int _shift = shift;
-	if (value.size()) {
-		int sign = (value.back()) >= 0 ? 1 : -1;
-
-		if (sign == -1)
-			for (size_t i = 0; i < value.size(); i++)
-				value[i] = -value[i];
-
-		while (_shift--) {
-			int carry = 0;
-			for (size_t i = 0; i < value.size(); i++)
-			{
-				value[i] = value[i] << 1;
-				value[i] += carry;
-				if (value[i] >= MODULUS) {
-					value[i] -= MODULUS;
-					carry = 1;
-				}
-				else
-					carry = 0;
-			}
-			if (carry) value.push_back(1);
-		}
-
-		if (sign == -1)
-			for (size_t i = 0; i < value.size(); i++)
-				value[i] = -value[i];
+	while (_shift && value.size()) {
+		unsigned int bits = std::min(_shift, (unsigned int) SHIFTBITS);
+		ShiftLeftBits(bits);
+		_shift -= bits;
 	}
 	return *this;
 }
@@ -187,36 +411,74 @@ pIntClass& pIntClass::operator<<=(const unsigned int shift)
 pIntClass& pIntClass::operator>>=(const unsigned int shift)
 {
 	unsigned int _shift = shift;
-	if (_shift && value.size()) {
-		int sign = (value.back()) >= 0 ? 1 : -1;
-
-		if (sign == -1)
-			for (size_t i = 0; i < value.size(); i++)
-				value[i] = -value[i];
-
-		while (_shift--) {
-			int carry = 0;
-			for (size_t i = value.size(); i > 0; i--)
-			{
-				if (carry)  value[i - 1] += MODULUS;
-				carry = (value[i - 1] & 1);
-				value[i - 1] = value[i - 1] >> 1;
-			}
-			if (value.back() == 0) value.pop_back();
-		}
-
-		if (sign == -1)
-			for (size_t i = 0; i < value.size(); i++)
-				value[i] = -value[i];
-		normalize(value);
+	while (_shift && value.size()) {
+		unsigned int bits = std::min(_shift, (unsigned int) SHIFTBITS);
+		ShiftRightBits(bits);
+		_shift -= bits;
 	}
 	return *this;
 }
 
+pIntClass& pIntClass::MulPow2(const unsigned int shift)
+{
+	return *this <<= shift;
+}
+
+/* this = this / 2^shift (truncated), returns this % 2^shift (with the sign of this) */
+pIntClass pIntClass::DivPow2(const unsigned int shift)
+{
+	pIntClass rem;
+	pIntClass scale(1);
+	unsigned int _shift = shift;
+	while (_shift && value.size()) {
+		unsigned int bits = std::min(_shift, (unsigned int) SHIFTBITS);
+		int r = ShiftRightBits(bits);
+		if (r) rem.AddMul(scale, r);
+		_shift -= bits;
+		if (_shift) scale.ShiftLeftBits(bits);
+	}
+	return rem;
+}
+
+/*
+*   this = MODULUS^k * rest, value[k] the first non-zero digit. 2^9 divides MODULUS, so
+*   the k zero digits count 9 bits each, and as MODULUS^7 is divisible by 2^63 the low
+*   63 bits of rest only depend on value[k], ..., value[k + 6]. Only a rest divisible
+*   by 2^63 needs a shifted copy.
+*/
+unsigned int pIntClass::TrailingZeroBits() const
+{
+	if (value.size() == 0) return 0;
+	size_t k = 0;
+	while (value[k] == 0) k++;
+
+	u64 low = 0;
+	u64 scale = 1;
+	for (size_t i = k; (i < value.size()) && (i < k + 7); i++) {
+		low += scale * (u64)((value[i] < 0) ? -value[i] : value[i]);
+		scale *= MODULUS;
+	}
+	low &= (((u64)1) << 63) - 1;
+
+	unsigned int count = 9 * (unsigned int)k;
+	if (low == 0) {
+		pIntClass t(*this);
+		t.ShiftLimbsRight((unsigned int)k);
+		t >>= 63;
+		return count + 63 + t.TrailingZeroBits();
+	}
+	while ((low & 1) == 0) { low = low >> 1; count++; }
+	return count;
+}
+
 #ifdef SSLIMIT
 
 #define OVERALLOCATION 2
 
+/* the FFT buffers come from the same memory resource as the digits */
+typedef std::allocator_traits<pIntVector::allocator_type>::rebind_alloc<Data> DataAllocator;
+typedef std::vector<Data, DataAllocator> DataVector;
+
 //#define PREALLOC
 #ifdef PREALLOC
 #define PREALLOCE 2000000
@@ -228,17 +490,32 @@ Data* imag3 = new Data[PREALLOCE];
 
 
 pIntClass pIntClass::SchoenhageStrassenMultiplication(const  pIntClass& rhs)
+{
+	if (!SchoenhageStrassenAccumulate(*this, rhs, 1, true))
+		return SchoolbookMultiplication(rhs);
+	return *this;
+}
+
+/*
+*   this += sign * a * b with the FFT. The radix 10^9 digits of the product are
+*   carried straight into value[] as they are taken out of the FFT buffer, so
+*   the product is never stored on its own.
+*   With replace == true value[] is cleared once the operands are loaded (*=),
+*   otherwise the result is left for the caller to normalize().
+*   Returns false, leaving value[] alone, if no FFT length is found for the product.
+*/
+bool pIntClass::SchoenhageStrassenAccumulate(const pIntClass& a, const pIntClass& b, int sign, bool replace)
 {
 
 	PrimeFactorDFT pf;
 	
 
-	int MySign = value.back() >= 0 ? 1 : -1;
-	int rhsSign = rhs.value.back() >= 0 ? 1 : -1;
+	int MySign = a.value.back() >= 0 ? 1 : -1;
+	int rhsSign = b.value.back() >= 0 ? 1 : -1;
 
 	factorSeq  factors;
 
-	u64 min_sz = value.size() +  rhs.value.size();
+	u64 min_sz = a.value.size() +  b.value.size();
 
 	pf.FastCalcFactors((unsigned int) (3 /** 2*/ * min_sz), factors);
 
@@ -248,10 +525,11 @@ pIntClass pIntClass::SchoenhageStrassenMultiplication(const  pIntClass& rhs)
 	if (pf.Status() > 0) {
 		/* this should be less dynamic, but right now it is OK */
 #ifndef PREALLOC
-		Data* real1 = new Data[pf.Status() + OVERALLOCATION];
-		Data* imag1 = new Data[pf.Status() + OVERALLOCATION];
-		Data* real3 = new Data[pf.Status() + OVERALLOCATION];
-		Data* imag3 = new Data[pf.Status() + OVERALLOCATION];
+		DataVector buffers(4 * (pf.Status() + OVERALLOCATION), 0, DataAllocator(Allocator()));
+		Data* real1 = buffers.data();
+		Data* imag1 = real1 + pf.Status() + OVERALLOCATION;
+		Data* real3 = imag1 + pf.Status() + OVERALLOCATION;
+		Data* imag3 = real3 + pf.Status() + OVERALLOCATION;
 #endif
 		for (s64 i = 0; i < pf.Status() + OVERALLOCATION; i++) {
 			real1[i] = 0;
@@ -260,8 +538,8 @@ pIntClass pIntClass::SchoenhageStrassenMultiplication(const  pIntClass& rhs)
 			imag3[i] = 0;
 		}
 
-		LoadFFT(value, real1);
-		LoadFFT(rhs.value, imag1);
+		LoadFFT(a.value, real1);
+		LoadFFT(b.value, imag1);
 
 		pf.forwardFFT(real1, imag1);
 
@@ -292,35 +570,38 @@ pIntClass pIntClass::SchoenhageStrassenMultiplication(const  pIntClass& rhs)
 
 		Carry(size, real1);
 
-		/* convert back to radix 10^9 from radix 10^3 double*/
-		value.clear();
-		for (int i = 0; i < pf.Status(); i += 3)
+		/* convert back to radix 10^9 from radix 10^3 double and add to value[] */
+		if (replace) value.clear();
+		size_t digits = (size_t)((size + 2) / 3);
+		if (value.size() < digits) value.resize(digits, 0);
+
+		s64 multiplier = sign * MySign * rhsSign;
+		s64 carry = 0;
+		size_t k = 0;
+		for (s64 i = 0; i < size; i += 3, k++)
 		{
-			int t0 = (int)real1[i];
-			int t1 = 1000 * (int)real1[i + 1];  // these values are 0 when we reach
-			int t2 = 1000 * 1000 * (int)real1[i + 2];// the end of buffer, due to
-			value.push_back(t0 + t1 + t2);//OVERALLOCATION
+			s64 t0 = (s64)real1[i];
+			s64 t1 = 1000 * (s64)real1[i + 1];  // these values are 0 when we reach
+			s64 t2 = 1000 * 1000 * (s64)real1[i + 2];// the end of buffer, due to
+			s64 t = value[k] + multiplier * (t0 + t1 + t2) + carry;//OVERALLOCATION
+			carry = t / MODULUS;
+			value[k] = (int)(t - carry * MODULUS);
 		}
-#ifndef PREALLOC
-		delete[] real1;
-		delete[] imag1;
-		delete[] real3;
-		delete[] imag3;
-#endif
-
-		while (value.size() && (value.back() == 0)) value.pop_back();
-		if((MySign * rhsSign) < 0) /* negative result*/
-			for( size_t ix = 0 ; ix < value.size(); ix++) 
-				value[ix] =  -value[ix];
-		
-		return *this;
+		for (; carry; k++) {
+			if (k == value.size()) value.push_back(0);
+			s64 t = value[k] + carry;
+			carry = t / MODULUS;
+			value[k] = (int)(t - carry * MODULUS);
+		}
+		if (replace) normalize(value);
+		return true;
 	}
-	return *this;
+	return false;
 }
 
 #define RMOD3 1000
 
-void pIntClass::LoadFFT(const std::vector<int>& A, double* Buffer)
+void pIntClass::LoadFFT(const pIntVector& A, double* Buffer)
 {
 	int carry = 0;
 	int FFTIndex = 0;
@@ -378,14 +659,6 @@ pIntClass& pIntClass::operator*=(const int rhs)
 }
 
 
-pIntClass operator*(const pIntClass& a, const pIntClass& b)
-{
-	pIntClass temp;// = new pIntClass();
-	temp = a;
-	temp *= b;
-	return temp;
-}
-
 bool operator<(const pIntClass& a, const pIntClass& b)
 {
 	if (a.IsPos() && b.IsPos()) { // a >= 0 and b >= 0
@@ -433,14 +706,6 @@ bool operator==(const pIntClass& a, const pIntClass& b)
 bool operator!=(const pIntClass& a, const pIntClass& b) {	return !operator==(a, b);  }
 
 
-pIntClass operator*(const int a, const pIntClass& b)
-{
-	pIntClass temp;// = new pIntClass();
-	temp = b;
-	(temp) *= a;
-	return temp;
-}
-
 
 
 void testMultiplication()
@@ -0,0 +1,226 @@
+/*
+Copyright   2024 Claus Vind - Andreasen
+
+This program is free software; you can redistribute it and /or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU General Public License for more details.
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111 - 1307 USA
+This General Public License does not permit incorporating your program into proprietary programs.If your program is a subroutine library, you may consider it more useful to permit linking proprietary applications with the library.
+If this is what you want to do, use the GNU Library General Public License instead of this License.
+*/
+
+#include <iostream>
+#include <mutex>
+#include "pIntClass.h"
+#include "pIntClassRns.h"
+#include "PrimeTable.h"
+
+pIntClass RemQuotient(const pIntClass& A, const pIntClass& M, pIntClass* Quotient);
+
+/* the odd primes below 2^16, enough to test candidates below 2^31 */
+static std::vector<uint32_t> SmallRnsPrimes()
+{
+	std::vector<uint32_t> small;
+	PrimeTable table(1 << 16);
+	for (uint32_t p = 3; p < (1 << 16); p += 2)
+		if (table.IsPrime(p)) small.push_back(p);
+	return small;
+}
+
+/* the count largest primes below 2^31, shared by all contexts: the list grows under the lock and the caller gets a copy */
+static std::vector<uint32_t> RnsPrimes(size_t count)
+{
+	static const std::vector<uint32_t> small = SmallRnsPrimes();
+	static std::vector<uint32_t> primes;
+	static std::mutex lock;
+	std::lock_guard<std::mutex> guard(lock);
+
+	uint32_t candidate = primes.empty() ? 0x7FFFFFFFu : primes.back() - 2;
+	while (primes.size() < count) {
+		bool prime = true;
+		for (size_t i = 0; i < small.size() && small[i] * small[i] <= candidate; i++)
+			if (candidate % small[i] == 0) {
+				prime = false;
+				break;
+			}
+		if (prime) primes.push_back(candidate);
+		candidate -= 2;
+	}
+	return std::vector<uint32_t>(primes.begin(), primes.begin() + count);
+}
+
+/* x^-1 mod p, p prime */
+static uint32_t InverseWord(uint32_t x, uint32_t p)
+{
+	u64 result = 1;
+	u64 b = x % p;
+	for (uint32_t e = p - 2; e; e >>= 1) {
+		if (e & 1) result = (result * b) % p;
+		b = (b * b) % p;
+	}
+	return (uint32_t)result;
+}
+
+RnsContext::RnsContext(size_t limbs)
+{
+	primes = RnsPrimes(limbs + 1);
+	size_t k = primes.size();
+
+	for (size_t i = 0; i < k; i++) {
+		inverses.push_back(1.0 / primes[i]);
+		divisors.push_back(pIntDivisor(primes[i]));
+	}
+
+	/* level l node i is the product of the primes i * 2^l .. (i + 1) * 2^l - 1 */
+	tree.push_back(std::vector<pIntClass>());
+	for (size_t i = 0; i < k; i++) tree[0].push_back(pIntClass((int)primes[i]));
+	while (tree.back().size() > 1) {
+		const std::vector<pIntClass>& below = tree.back();
+		std::vector<pIntClass> level;
+		for (size_t i = 0; i + 1 < below.size(); i += 2) level.push_back(below[i] * below[i + 1]);
+		if (below.size() & 1) level.push_back(below.back());
+		tree.push_back(level);
+	}
+
+	half = Modulus();
+	half.DivModInt(2);
+
+	cofactors.assign(k, 1);
+	std::vector<uint32_t> scratch(k);
+	Cofactors(tree.size() - 1, 0, scratch.data());
+	for (size_t i = 0; i < k; i++) cofactors[i] = InverseWord(cofactors[i], primes[i]);
+}
+
+/* cofactors[i] *= (P / p[i]) mod p[i] for the primes of P = tree[level][index] */
+void RnsContext::Cofactors(size_t level, size_t index, uint32_t* scratch)
+{
+	size_t first = index << level;
+	size_t count = std::min((size_t)1 << level, primes.size() - first);
+	if (count <= RNSTREELIMIT) {
+		for (size_t i = first; i < first + count; i++)
+			for (size_t j = first; j < first + count; j++) {
+				if (j == i) continue;
+				u64 rem;
+				divisors[i].DivRem((u64)cofactors[i] * primes[j], rem);
+				cofactors[i] = (uint32_t)rem;
+			}
+		return;
+	}
+
+	/* P / p[i] = (the other child) * (the child of p[i]) / p[i] */
+	size_t left = 2 * index, right = 2 * index + 1;
+	if (right < tree[level - 1].size()) {
+		Residues(tree[level - 1][right], level - 1, left, scratch);
+		Residues(tree[level - 1][left], level - 1, right, scratch);
+		for (size_t i = first; i < first + count; i++) {
+			u64 rem;
+			divisors[i].DivRem((u64)cofactors[i] * scratch[i], rem);
+			cofactors[i] = (uint32_t)rem;
+		}
+		Cofactors(level - 1, right, scratch);
+	}
+	Cofactors(level - 1, left, scratch);
+}
+
+/* residues of x modulo the primes of tree[level][index] */
+void RnsContext::Residues(const pIntClass& x, size_t level, size_t index, uint32_t* residues) const
+{
+	size_t first = index << level;
+	size_t count = std::min((size_t)1 << level, primes.size() - first);
+	if (count <= RNSTREELIMIT) {
+		x.ModInts(&divisors[first], count, &residues[first]);
+		return;
+	}
+	for (size_t child = 2 * index; child < std::min(2 * index + 2, tree[level - 1].size()); child++)
+		Residues(RemQuotient(x, tree[level - 1][child], NULL), level - 1, child, residues);
+}
+
+void RnsContext::ToRns(const pIntClass& x, uint32_t* residues) const
+{
+	if (primes.size() <= RNSTREELIMIT) {
+		x.ModInts(divisors.data(), primes.size(), residues);
+		return;
+	}
+	Residues(RemQuotient(x, Modulus(), NULL), tree.size() - 1, 0, residues);
+}
+
+void RnsContext::ToRns(int x, uint32_t* residues) const
+{
+	for (size_t i = 0; i < primes.size(); i++) {
+		s64 r = x % (s64)primes[i];
+		residues[i] = (uint32_t)((r < 0) ? r + primes[i] : r);
+	}
+}
+
+pIntClass RnsContext::FromRns(const uint32_t* residues) const
+{
+	size_t k = primes.size();
+	std::vector<pIntClass> sums;
+	sums.reserve(k);
+	for (size_t i = 0; i < k; i++) {
+		u64 rem;
+		divisors[i].DivRem((u64)residues[i] * cofactors[i], rem);
+		sums.push_back(pIntClass((int)rem));
+	}
+
+	for (size_t level = 0; sums.size() > 1; level++) {
+		std::vector<pIntClass> next;
+		next.reserve((sums.size() + 1) / 2);
+		for (size_t i = 0; i + 1 < sums.size(); i += 2)
+			next.push_back(sums[i] * tree[level][i + 1] + sums[i + 1] * tree[level][i]);
+		if (sums.size() & 1) next.push_back(sums.back());
+		sums.swap(next);
+	}
+
+	/* sum c[i] * M / p[i] < k * M */
+	pIntClass x = RemQuotient(sums[0], Modulus(), NULL);
+	if (half < x) x -= Modulus();
+	return x;
+}
+
+void RnsContext::Add(const uint32_t* a, const uint32_t* b, uint32_t* r) const
+{
+	const uint32_t* p = primes.data();
+	for (size_t i = 0; i < primes.size(); i++) {
+		uint32_t s = a[i] + b[i];               // < 2^32
+		r[i] = s - ((s >= p[i]) ? p[i] : 0);
+	}
+}
+
+void RnsContext::Sub(const uint32_t* a, const uint32_t* b, uint32_t* r) const
+{
+	const uint32_t* p = primes.data();
+	for (size_t i = 0; i < primes.size(); i++) {
+		uint32_t s = a[i] - b[i];
+		r[i] = s + ((a[i] < b[i]) ? p[i] : 0);
+	}
+}
+
+/* the quotient from a double product is at most 1 off, so the remainder is in [-p, 2p[ */
+void RnsContext::Mul(const uint32_t* a, const uint32_t* b, uint32_t* r) const
+{
+	const uint32_t* p = primes.data();
+	const double* inv = inverses.data();
+	for (size_t i = 0; i < primes.size(); i++) {
+		u64 t = (u64)a[i] * b[i];
+		u64 q = (u64)((double)a[i] * (double)b[i] * inv[i]);
+		s64 s = (s64)(t - q * p[i]);
+		s += (s < 0) ? p[i] : 0;
+		s -= (s >= (s64)p[i]) ? p[i] : 0;
+		r[i] = (uint32_t)s;
+	}
+}
+
+
+RnsNumber::RnsNumber(const RnsContext& context) : ctx(&context), r(context.Count(), 0)
+{
+}
+
+RnsNumber::RnsNumber(const RnsContext& context, const pIntClass& x) : ctx(&context), r(context.Count())
+{
+	ctx->ToRns(x, r.data());
+}
+
+RnsNumber::RnsNumber(const RnsContext& context, int x) : ctx(&context), r(context.Count())
+{
+	ctx->ToRns(x, r.data());
+}
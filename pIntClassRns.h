@@ -0,0 +1,87 @@
+#pragma once
+/*
+Copyright   2024 Claus Vind - Andreasen
+
+This program is free software; you can redistribute it and /or modify it under the terms of the GNU General Public License as published by the Free Software Foundation; either version 2 of the License, or (at your option) any later version.
+This program is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the GNU General Public License for more details.
+You should have received a copy of the GNU General Public License along with this program; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111 - 1307 USA
+This General Public License does not permit incorporating your program into proprietary programs.If your program is a subroutine library, you may consider it more useful to permit linking proprietary applications with the library.
+If this is what you want to do, use the GNU Library General Public License instead of this License.
+*/
+
+#include <vector>
+#include "pIntClass.h"
+
+/*
+*   Residue number system: x is kept as x mod p[i] for k primes 2^30 < p[i] < 2^31, the largest
+*   below 2^31 (found with PrimeTable).  Additions and multiplications are k independent word
+*   operations (plain loops without branches, vectorizable), one CRT reconstruction at the end
+*   gives x in ]-M/2, M/2], M = prod p[i].  As p[i] > 2 * MODULUS, k = limbs + 1 primes cover
+*   |x| < MODULUS^limbs.
+*
+*   The products of the primes are kept in a binary tree (level 0 the primes, the top M):
+*       ToRns:    x is reduced modulo the node products down the tree until a node has
+*                 at most RNSTREELIMIT primes, then one ModInts pass gives their residues
+*       FromRns:  x = sum c[i] * M / p[i],  c[i] = r[i] * (M / p[i])^-1 mod p[i], summed pairwise
+*                 up the tree, v = v_left * P_right + v_right * P_left, then reduced mod M
+*   both cost O(log k) full size multiplications / divisions instead of O(k^2) word operations.
+*/
+#define RNSTREELIMIT 64
+
+class RnsContext
+{
+public:
+
+	/* enough primes for |x| < MODULUS^limbs */
+	RnsContext(size_t limbs);
+
+	size_t Count() const { return primes.size(); }
+	const uint32_t* Primes() const { return primes.data(); }
+	const pIntClass& Modulus() const { return tree.back()[0]; }
+
+	void ToRns(const pIntClass& x, uint32_t* residues) const;
+	void ToRns(int x, uint32_t* residues) const;
+	pIntClass FromRns(const uint32_t* residues) const;   // the x in ]-M/2, M/2] with these residues
+
+	/* r[i] = a[i] op b[i] mod p[i], r may be a or b */
+	void Add(const uint32_t* a, const uint32_t* b, uint32_t* r) const;
+	void Sub(const uint32_t* a, const uint32_t* b, uint32_t* r) const;
+	void Mul(const uint32_t* a, const uint32_t* b, uint32_t* r) const;
+
+private:
+	std::vector<uint32_t> primes;
+	std::vector<double> inverses;           // 1.0 / p[i]
+	std::vector<pIntDivisor> divisors;
+	std::vector<uint32_t> cofactors;        // (M / p[i])^-1 mod p[i]
+	std::vector<std::vector<pIntClass> > tree;
+	pIntClass half;                         // floor(M / 2)
+
+	void Residues(const pIntClass& x, size_t level, size_t index, uint32_t* residues) const;
+	void Cofactors(size_t level, size_t index, uint32_t* scratch);
+};
+
+
+/* a number in residue form, all operands of an operation must share the context */
+class RnsNumber
+{
+public:
+
+	RnsNumber(const RnsContext& context);   // 0
+	RnsNumber(const RnsContext& context, const pIntClass& x);
+	RnsNumber(const RnsContext& context, int x);
+
+	RnsNumber& operator+=(const RnsNumber& b) { ctx->Add(r.data(), b.r.data(), r.data()); return *this; }
+	RnsNumber& operator-=(const RnsNumber& b) { ctx->Sub(r.data(), b.r.data(), r.data()); return *this; }
+	RnsNumber& operator*=(const RnsNumber& b) { ctx->Mul(r.data(), b.r.data(), r.data()); return *this; }
+
+	RnsNumber operator+(const RnsNumber& b) const { RnsNumber t(*this); return t += b; }
+	RnsNumber operator-(const RnsNumber& b) const { RnsNumber t(*this); return t -= b; }
+	RnsNumber operator*(const RnsNumber& b) const { RnsNumber t(*this); return t *= b; }
+
+	pIntClass Value() const { return ctx->FromRns(r.data()); }
+	const uint32_t* Residues() const { return r.data(); }
+
+private:
+	const RnsContext* ctx;
+	std::vector<uint32_t> r;
+};
@@ -10,6 +10,9 @@ If this is what you want to do, use the GNU Library General Public License inste
 */
 
 #include <iostream>
+#include <thread>
+#include <atomic>
+#include <cmath>
 //#define PERF
 #ifdef PERF
 //#include "winnt.h"
@@ -21,6 +24,7 @@ If this is what you want to do, use the GNU Library General Public License inste
 #include "pIntClass.h"
 #include "pIntClassRandom.h"
 #include "pIntClassUtil.h"
+#include "pIntClassModular.h"
 
 
 pIntClass exponentiation(int  a, int exp)
@@ -67,103 +71,335 @@ pIntClass RemQuotient(const pIntClass& A, const pIntClass& M, pIntClass* Quotien
 		return Rem;
 	}
 	else if ((A.value.size() == 1) && (M.value.size() == 1)) {
-		/* small numbers both less than RMOD */
-		if (Quotient != NULL)
-		{
-			Quotient->value.clear();
-			Quotient->value.push_back(A.value[0] / M.value[0]);
+		/* small numbers both less than RMOD, the remainder is made non-negative as below */
+		int q = A.value[0] / M.value[0];
+		int r = A.value[0] % M.value[0];
+		if (r < 0) {
+			r += (M.value[0] < 0) ? -M.value[0] : M.value[0];
+			q -= (M.value[0] < 0) ? -1 : 1;
 		}
+		if (Quotient != NULL)
+			*Quotient = q;
 
-		Rem.value.push_back( A.value[0] % M.value[0]);
-        Rem.normalize(Rem.value);
+		Rem = r;
 		return Rem;
 	}
 	else {
-        pIntClass  _dividend(A);
-        pIntClass  _divisor(M);
-        int     reciprocal = pIntClass::MODULUS / (2 + _divisor.value.back());
-        int     shift = (int)M.value.size();
-		pIntClass  _reciprocal(reciprocal);
-
-        Rem = reciprocal;
-		Rem *= _dividend;
-
-		if (!Rem.IsZero())  
-            for (int i = 0; i < shift;i++)	Rem.DivModulus();
-
-		while (1)
-		{
-			_Quotient = Rem;
-			Rem *= _divisor;
-            Rem.ChSignBit();
-			Rem += _dividend;
-
-			if (_divisor.IsBiggerNummerically(Rem)) 	
-                break;
-
-			Rem *= _reciprocal;
-			for (int i = 0; i < shift;i++) {
-				Rem.DivModulus();
-			}
-			if (Rem.IsZero())
-				Rem = 1;
-			Rem += _Quotient;
-		}
-		/* we are done */
-		if (Rem.IsNeg())
-		{
+		/* divide the magnitudes, then make the remainder non-negative */
+		pIntClass  _dividend(A);
+		pIntClass  _divisor(M);
+		int ASign = _dividend.IsNeg() ? -1 : 1;
+		int MSign = _divisor.IsNeg() ? -1 : 1;
+		if (ASign < 0) _dividend.ChSignBit();
+		if (MSign < 0) _divisor.ChSignBit();
+
+#ifdef NEWTONLIMIT
+		if (M.value.size() >= NEWTONLIMIT)
+			pIntClass::NewtonDivide(_dividend, _divisor, _Quotient, Rem);
+		else
+#endif
+		if (M.value.size() >= 2 * BZLIMIT)
+			pIntClass::BurnikelZieglerDivide(_dividend, _divisor, _Quotient, Rem);
+		else
+			pIntClass::KnuthDivide(_dividend, _divisor, _Quotient, Rem);
+
+		if (ASign * MSign < 0) _Quotient.ChSignBit();
+		if ((ASign < 0) && !Rem.IsZero()) {
+			Rem.ChSignBit();
 			Rem += _divisor;
-			_Quotient += -1;
+			_Quotient -= MSign;
 		}
 		if (Quotient)  *Quotient = _Quotient;
 		return Rem;
 	}
 }
 
-int Jacobi(const pIntClass& a, const pIntClass& b)
-{
+/*
+*   GCD.  (a, b) is reduced by unimodular 2x2 matrices, so gcd(a, b) never changes and the
+*   product of the matrices gives the cofactors of the extended GCD.
+*
+*   Lehmer: the quotients are computed from the leading 9 digits of a and b and collected
+*   in a matrix of int cofactors, which is applied to a and b with two multiplications
+*   by an int each, instead of one division per quotient.
+*   Above GCDLIMIT limbs to remove the matrix is computed recursively from the leading limbs
+*   only (half-GCD) and applied with the library multiplication.
+*/
+#define GCDLIMIT 100
+/* BatchModInverse gives a thread at least this many values */
+#define BATCHINVERSECHUNK 64
+/* Jacobi symbols of smaller numbers use the binary algorithm */
+#define JACOBILIMIT 3
+
+struct GcdMatrix {
+	pIntClass m00, m01, m10, m11;
+	GcdMatrix() : m00(1), m01(0), m10(0), m11(1) {};
+};
 
-	pIntClass A(a);
-	pIntClass M(b);
-	int ResSign = 1;
-	if (M.IsZero())
-		return 1;
-	else {
-		A =RemQuotient(A, M, NULL);
-		if (A.IsZero()) {  //A|M 
-			return 0;
+/*
+*   The Jacobi symbol along a quotient sequence: the pair (a, b) is the current (first, second),
+*   one of them odd and the denominator, the symbol is sign * (numerator / denominator).
+*   The residues mod 8 of a and b follow from the quotients, 10^9 is divisible by 8.
+*/
+struct JacobiState {
+	int r0, r1;     // a mod 8, b mod 8
+	int den;        // 0 : a is the denominator, 1 : b
+	int sign;
+};
+
+static int Jacobi2(int x) { return ((x & 7) == 3 || (x & 7) == 5) ? -1 : 1; }                 // (2 / x)
+static int Reciprocity(int x, int y) { return ((x & 3) == 3 && (y & 3) == 3) ? -1 : 1; }      // (x / y)(y / x)
+
+/* (a, b) = (b, a - q * b) */
+static void JacobiQuotient(JacobiState* J, int q8)
+{
+	int x = J->r0, y = J->r1;
+	int xn = (x - q8 * y) & 7;
+	if (J->den == 0) {
+		if (y & 1) {
+			/* (y / x) = (x / y) * eps = (xn / y) * eps, y becomes the denominator */
+			J->sign *= Reciprocity(x, y);
+			J->den = 1;
 		}
-		else {
-			while (!A.IsZero()) {
-				while (!A.IsZero() && ((A[0] & 1) == 0))
-				{
-					A >>= 1;
-					switch (M[0] & 0x7)
-					{
-					case 3: 
-                    case 5:   
-                        ResSign = -ResSign;
-						break;
-					default:
-						break;
-					}
-				}
-				pIntClass temp;
-				temp = A;
-				A = M;
-				M = temp;
-				if (!A.IsZero() && !M.IsZero() && (3 == (A[0] & 0x3)) && (3 == (M[0] & 0x3))) 
-                    ResSign = -ResSign;
-
-                A = RemQuotient(A, M, NULL);
-			}
-			if ((M == 1))
-				return ResSign;
-			else
-				return 0;
+		else if ((y & 3) == 2) {
+			/* y = 2 * y0 : (y / x) = (y / xn) (2 / x)(2 / xn) eps(x, y0) eps(xn, y0), for 4 | y they cancel */
+			int y0 = y >> 1;
+			J->sign *= Jacobi2(x) * Jacobi2(xn) * Reciprocity(x, y0) * Reciprocity(xn, y0);
 		}
 	}
-};
+	J->r0 = y;
+	J->r1 = xn;
+	J->den = 1 - J->den;
+}
+
+/* rows of M follow the rows of (a, b) */
+static void SwapRows(pIntClass& a, pIntClass& b, GcdMatrix* M)
+{
+	std::swap(a, b);
+	if (M) {
+		std::swap(M->m00, M->m10);
+		std::swap(M->m01, M->m11);
+	}
+}
+
+/* (a, b) = S (a, b), M = S M, then a >= b >= 0 again */
+static void ApplyMatrix(pIntClass& a, pIntClass& b, GcdMatrix* M, const GcdMatrix& S)
+{
+	pIntClass na = S.m00 * a + S.m01 * b;
+	pIntClass nb = S.m10 * a + S.m11 * b;
+	a = na;
+	b = nb;
+	if (M) {
+		pIntClass t00 = S.m00 * M->m00 + S.m01 * M->m10;
+		pIntClass t01 = S.m00 * M->m01 + S.m01 * M->m11;
+		pIntClass t10 = S.m10 * M->m00 + S.m11 * M->m10;
+		pIntClass t11 = S.m10 * M->m01 + S.m11 * M->m11;
+		M->m00 = t00; M->m01 = t01; M->m10 = t10; M->m11 = t11;
+	}
+	if (a.IsNeg()) {
+		a.ChSignBit();
+		if (M) { M->m00.ChSignBit(); M->m01.ChSignBit(); }
+	}
+	if (b.IsNeg()) {
+		b.ChSignBit();
+		if (M) { M->m10.ChSignBit(); M->m11.ChSignBit(); }
+	}
+	if (a < b) SwapRows(a, b, M);
+}
+
+/* (a, b) = (b, a mod b) */
+static void DivisionStep(pIntClass& a, pIntClass& b, GcdMatrix* M, JacobiState* J = NULL)
+{
+	pIntClass q;
+	pIntClass r = RemQuotient(a, b, &q);
+	if (J) JacobiQuotient(J, q[0] & 7);
+	a = b;
+	b = r;
+	if (M) {
+		pIntClass t = M->m00;
+		t.SubMul(q, M->m10);
+		M->m00 = M->m10;
+		M->m10 = t;
+		t = M->m01;
+		t.SubMul(q, M->m11);
+		M->m01 = M->m11;
+		M->m11 = t;
+	}
+}
+
+/* one Lehmer step on a >= b > 0 (Knuth, Algorithm L), false if the leading digits decide no quotient */
+static bool LehmerStep(pIntClass& a, pIntClass& b, GcdMatrix* M, JacobiState* J = NULL)
+{
+	int n = a.Size();
+	s64 x = (s64)a[n - 1] * pIntClass::MODULUS + ((n > 1) ? a[n - 2] : 0);
+	s64 y = (s64)b[n - 1] * pIntClass::MODULUS + ((n > 1) ? b[n - 2] : 0);
+	while (x >= pIntClass::MODULUS) { x /= 10; y /= 10; }
+
+	s64 A = 1, B = 0, C = 0, D = 1;
+	JacobiState J0;
+	if (J) J0 = *J;
+	while (y + C != 0 && y + D != 0) {
+		s64 q = (x + A) / (y + C);
+		if (q != (x + B) / (y + D)) break;
+		s64 t = A - q * C; A = C; C = t;
+		t = B - q * D; B = D; D = t;
+		t = x - q * y; x = y; y = t;
+		if (J) JacobiQuotient(&J0, (int)(q & 7));
+	}
+	if (B == 0) return false;
+	if (J) *J = J0;
+
+	pIntClass na = a * (int)A + b * (int)B;
+	pIntClass nb = a * (int)C + b * (int)D;
+	a = na;
+	b = nb;
+	if (M) {
+		pIntClass t0 = M->m00 * (int)A + M->m10 * (int)B;
+		pIntClass t1 = M->m01 * (int)A + M->m11 * (int)B;
+		M->m10 = M->m00 * (int)C + M->m10 * (int)D;
+		M->m11 = M->m01 * (int)C + M->m11 * (int)D;
+		M->m00 = t0;
+		M->m01 = t1;
+	}
+	return true;
+}
+
+/* reduces a >= b >= 0 until b has at most stop limbs */
+static void GcdReduce(pIntClass& a, pIntClass& b, GcdMatrix* M, int stop)
+{
+	while (!b.IsZero() && b.Size() > stop) {
+		int n = a.Size();
+		int d = n - stop;
+		if (d < GCDLIMIT) {
+			if (!LehmerStep(a, b, M)) DivisionStep(a, b, M);
+			continue;
+		}
+
+		/* removing r limbs takes about the leading 2r limbs */
+		int r = d / 2;
+		int h = std::max(n - 2 * r - 2, 0);
+		pIntClass a1 = a;
+		pIntClass b1 = b;
+		a1.ShiftLimbsRight((unsigned int)h);
+		b1.ShiftLimbsRight((unsigned int)h);
+		GcdMatrix S;
+		GcdReduce(a1, b1, &S, a1.Size() - r);
+
+		int sa = a.Size(), sb = b.Size();
+		ApplyMatrix(a, b, M, S);
+		if (a.Size() >= sa && b.Size() >= sb) DivisionStep(a, b, M);
+	}
+}
+
+/* binary GCD of two machine words */
+static u64 BinaryGcd(u64 x, u64 y)
+{
+	if (x == 0) return y;
+	if (y == 0) return x;
+	int shift = 0;
+	while (((x | y) & 1) == 0) { x >>= 1; y >>= 1; shift++; }
+	while ((x & 1) == 0) x >>= 1;
+	while (y) {
+		while ((y & 1) == 0) y >>= 1;
+		if (x > y) std::swap(x, y);
+		y -= x;
+	}
+	return x << shift;
+}
+
+pIntClass Gcd(const pIntClass& a, const pIntClass& b)
+{
+	pIntClass x = a;
+	pIntClass y = b;
+	if (x.IsNeg()) x.ChSignBit();
+	if (y.IsNeg()) y.ChSignBit();
+	if (x < y) std::swap(x, y);
+
+	GcdReduce(x, y, NULL, 2);
+	while (!y.IsZero() && x.Size() > 2) DivisionStep(x, y, NULL);
+	if (y.IsZero()) return x;
+
+	u64 g = BinaryGcd((u64)x[1] * pIntClass::MODULUS + x[0], (u64)y[1] * pIntClass::MODULUS + y[0]);
+	pIntClass res((int)(g / pIntClass::MODULUS));
+	res.ShiftLimbsLeft(1);
+	res += (int)(g % pIntClass::MODULUS);
+	return res;
+}
+
+pIntClass ExtendedGcd(const pIntClass& a, const pIntClass& b, pIntClass* x, pIntClass* y)
+{
+	pIntClass A = a;
+	pIntClass B = b;
+	if (A.IsNeg()) A.ChSignBit();
+	if (B.IsNeg()) B.ChSignBit();
+	GcdMatrix M;
+	if (A < B) SwapRows(A, B, &M);
+
+	GcdReduce(A, B, &M, 0);
+
+	/* A = m00 * |a| + m01 * |b| */
+	if (a.IsNeg()) M.m00.ChSignBit();
+	if (b.IsNeg()) M.m01.ChSignBit();
+	if (x) *x = M.m00;
+	if (y) *y = M.m01;
+	return A;
+}
+
+bool ModInverse(const pIntClass& a, const pIntClass& m, pIntClass& inv)
+{
+	pIntClass x;
+	if (m.IsZero() || !ExtendedGcd(a, m, &x, NULL).IsOne()) {
+		inv = 0;
+		return false;
+	}
+	inv = RemQuotient(x, m, NULL);
+	return true;
+}
+
+/* inverses[i] = 1 / values[i] for one chunk, Montgomery's trick with the reducer of the caller */
+static bool BatchModInverseChunk(const pIntClass* values, size_t count, const ModReducer& r, pIntClass* inverses)
+{
+	if (count == 0) return true;
+
+	/* inverses[i] = values[0] * ... * values[i] for now */
+	inverses[0] = r.Reduce(values[0]);
+	for (size_t i = 1; i < count; i++) inverses[i] = r.Multiply(inverses[i - 1], values[i]);
+
+	pIntClass inv;
+	if (!ModInverse(inverses[count - 1], r.Modulus(), inv)) {
+		/* some value has no inverse, find out which one by one */
+		bool ok = true;
+		for (size_t i = 0; i < count; i++) ok &= ModInverse(values[i], r.Modulus(), inverses[i]);
+		return ok;
+	}
+	for (size_t i = count - 1; i > 0; i--) {
+		inverses[i] = r.Multiply(inv, inverses[i - 1]);
+		inv = r.Multiply(inv, values[i]);
+	}
+	inverses[0] = inv;
+	return true;
+}
+
+bool BatchModInverse(const pIntClass* values, size_t count, const pIntClass& m, pIntClass* inverses, int threads)
+{
+	ModReducer r(m);
+	if (!r.IsValid()) return false;
+
+	size_t chunks = (threads > 1) ? std::min((size_t)threads, count / BATCHINVERSECHUNK) : 1;
+	if (chunks <= 1)
+		return BatchModInverseChunk(values, count, r, inverses);
+
+	/* one inversion per chunk, every thread has its own chunk */
+	std::vector<std::thread> workers;
+	std::vector<char> ok(chunks, 1);
+	size_t size = (count + chunks - 1) / chunks;
+	for (size_t t = 0; t < chunks; t++) {
+		size_t from = t * size;
+		size_t n = std::min(size, count - from);
+		workers.emplace_back([=, &r, &ok]() { ok[t] = BatchModInverseChunk(values + from, n, r, inverses + from); });
+	}
+	for (auto& w : workers) w.join();
+	return std::find(ok.begin(), ok.end(), 0) == ok.end();
+}
 
 
 void testTonelliShanks()
@@ -223,16 +459,13 @@ bool  TonelliShanks(const pIntClass& n, const pIntClass& p, pIntClass& res) {
 
 	// Factor out powers of 2 from p - 1
 	pIntClass q = p; q -= 1;
-	int s = 0;
-	while (((q[0] & 1) == 0)) {
-		if (q.IsZero()) {
-            res = 0;
-			std::cout << "not a square " << std::endl;
-			return false;
-		}
-		q >>= 1;
-		s++;
+	if (q.IsZero()) {
+        res = 0;
+		std::cout << "not a square " << std::endl;
+		return false;
 	}
+	int s = q.TrailingZeroBits();
+	q >>= s;
 
 	// Find a non-square z such as ( z | p ) = -1
 	pIntClass z = 2;
@@ -252,7 +485,9 @@ bool  TonelliShanks(const pIntClass& n, const pIntClass& p, pIntClass& res) {
 	pIntClass  t = modpow(n, q, p);
 	pIntClass  m = s;
 	pIntClass  m_1 = m; m_1;
-	pIntClass  result = modpow(n, (q + 1) >>= 1, p);
+	pIntClass  result = modpow(n, pIntClass(q + 1) >>= 1, p);
+	BarrettContext bp(p);
+	FixedBasePow two(2, p, 32);     // 2^(m - i - 1), m <= s
 
 	//std::cout << " c: " << c.ToString() << std::endl;
 	//std::cout << " t: " << t.ToString() << std::endl;
@@ -274,7 +509,7 @@ loop:
 	pIntClass t1 = t;
 	do {
 		i++;
-		t1 = modmult(t1, t1, p);
+		t1 = bp.Square(t1);
 	} while (!t1.IsOne());
 
 
@@ -285,13 +520,13 @@ loop:
 
 	pIntClass temp2;
 
-	temp2 = modpow(2, temp1, p);
+	temp2 = two.Pow(temp1);
 
 	pIntClass  b = modpow(c, temp2, p);
-	c = modmult(b, b, p);
-	t = modmult(t, c, p);
+	c = bp.Square(b);
+	t = bp.Multiply(t, c);
 	m = i;
-	result = modmult(result, b, p);
+	result = bp.Multiply(result, b);
 	//std::cout << " c: " << c.ToString() << std::endl;
 	//std::cout << " t: " << t.ToString() << std::endl;
 	//std::cout << " R: " << result.ToString() << std::endl;
@@ -305,38 +540,35 @@ loop:
 
 pIntClass modmult(const pIntClass &_a, const pIntClass &_b, const pIntClass &mod) {  // Compute a*b % mod
     pIntClass result;// = new pIntClass;
-    pIntClass a = _a;
-    pIntClass b = _b;
-    while (!b.IsZero()) {
-
-        if ((b[0] & 1) == 1) {
-            result += a;
-            result = RemQuotient(result, mod, NULL);
-        }
-        a = a + a;
-        a = RemQuotient(a, mod, NULL);
-        b >>= 1;
-    }
-    return result;
+    result.AddMul(_a, _b);
+    unsigned int k;
+    int c;
+    ModReducer::Form form = ModReducer::Detect(mod, k, c);
+    if (form != ModReducer::GENERIC)
+        return ModReducer(mod, form, k, c).Reduce(result);
+    return RemQuotient(result, mod, NULL);
 }
 
 pIntClass modpow(const pIntClass& _a, const pIntClass& _b, const pIntClass& mod) {  // Compute a^b % mod
-    pIntClass result;// = new pIntClass();
-    pIntClass  a = _a;
-    pIntClass  b = _b;
-    pIntClass t;
-    ++(result);
-
-    while (!b.IsZero()) {
-        if ((b[0] & 1) == 1) {
-            t = modmult(result, a, mod);
-            result = t;
-        }
-        a = modmult(a, a, mod);
-        b >>= 1;
+    /* 10^k +- c by digit shifts, moduli coprime to 10 without division, the rest with a cached reciprocal */
+    pIntClass m = mod;
+    if (m.IsNeg()) m.ChSignBit();
+    unsigned int k;
+    int c;
+    ModReducer::Form form = ModReducer::Detect(m, k, c);
+    if (form != ModReducer::GENERIC) {
+        ModReducer ctx(m, form, k, c);
+        return ctx.Pow(_a, _b);
+    }
+    uint32_t last = m.ModInt(10);
+    if (!m.IsOne() && (last & 1) && last != 5) {
+        MontgomeryContext ctx(m);
+        return ctx.Pow(_a, _b);
     }
 
-    return result;
+    BarrettContext ctx(m);
+    if (!ctx.IsValid()) return pIntClass();
+    return ctx.Pow(_a, _b);
 }
 
 void testMR1(int &npcount, int &pcount, int width,  pIntClass& p)
@@ -408,15 +640,91 @@ void testMR()
     }
 }
 
-bool MillerRabin(const pIntClass& number, int witnesses)
+/* the odd primes up to SMALLFACTORLIMIT, in groups whose product fits a word, built once */
+struct SmallPrimeGroups {
+	std::vector<uint32_t> primes;
+	std::vector<pIntDivisor> products;
+	std::vector<size_t> ends;       // group j is primes[ends[j - 1]] .. primes[ends[j] - 1]
+
+	SmallPrimeGroups() {
+		PrimeTable table(SMALLFACTORLIMIT + 1);
+		u64 product = 1;
+		for (uint32_t p = 3; p <= SMALLFACTORLIMIT; p += 2) {
+			if (!table.IsPrime(p)) continue;
+			if (product * p > 0xFFFFFFFFu) {
+				products.push_back(pIntDivisor((uint32_t)product));
+				ends.push_back(primes.size());
+				product = 1;
+			}
+			primes.push_back(p);
+			product *= p;
+		}
+		if (product > 1) {
+			products.push_back(pIntDivisor((uint32_t)product));
+			ends.push_back(primes.size());
+		}
+	}
+};
+
+bool HasSmallFactor(const pIntClass& n, uint32_t bound, uint32_t* factor)
+{
+	pIntClass t = n;
+	if (bound >= 2 && !t.IsZero() && (t[0] & 1) == 0) {
+		if (factor) *factor = 2;
+		return true;
+	}
+	if (bound < 3) return false;
+
+	/* initialized once, thread safe, and never changed after */
+	static const SmallPrimeGroups groups;
+	size_t count = std::upper_bound(groups.primes.begin(), groups.primes.end(), bound) - groups.primes.begin();
+	size_t ngroups = std::lower_bound(groups.ends.begin(), groups.ends.end(), count) - groups.ends.begin() + 1;
+	ngroups = std::min(ngroups, groups.ends.size());
+
+	std::vector<uint32_t> remainders(ngroups);
+	n.ModInts(groups.products.data(), ngroups, remainders.data());
+	for (size_t j = 0, i = 0; j < ngroups; j++)
+		for (; i < groups.ends[j] && i < count; i++)
+			if (remainders[j] % groups.primes[i] == 0) {
+				if (factor) *factor = groups.primes[i];
+				return true;
+			}
+	return false;
+}
+
+/* n - 1 = d * 2^s, strong probable prime to base a */
+static bool StrongProbablePrime(const MontgomeryContext& ctx, const pIntClass& d, unsigned int s, const pIntClass& a)
+{
+	pIntClass minusone = ctx.Modulus();
+	minusone -= ctx.One();
+	pIntClass x = ctx.ToMontgomery(ctx.Pow(a, d));
+	if (x == ctx.One() || x == minusone) return true;
+	for (unsigned int i = 1; i < s; i++) {
+		x = ctx.Square(x);
+		if (x == minusone) return true;
+		if (x == ctx.One()) return false;
+	}
+	return false;
+}
+
+bool MillerRabin(const pIntClass& number, int witnesses, uint32_t trialbound, int threads)
 {
     pIntClass m = number;
+    uint32_t factor;
 
     if (!m.IsZero() && ((m[0] & 1) == 0 )) {
         std::cout << "argument must be odd " << std::endl;
         return false;
     }
+    else if (m.ModInt(5) == 0 || m.IsOne() || m.IsZero()) {
+        return m == pIntClass(5);
+    }
+    else if (HasSmallFactor(m, trialbound, &factor)) {
+        return m == pIntClass((int)factor);
+    }
     else {
+        /* the squarings stay in Montgomery form, 1 and m - 1 are compared as R and m - R */
+        MontgomeryContext ctx(m);
 
         pIntClassRandom Rands(pIntClass::MODULUS);
 
@@ -429,39 +737,194 @@ bool MillerRabin(const pIntClass& number, int witnesses)
         
         d -= 1;
         
-        int s = 0;
-        while (!d.IsZero() && ((d[0] & 1) == 0)) {
-            d >>= 1;
-            s++;
+        int s = d.TrailingZeroBits();
+        d >>= s;
+
+        /* the witnesses are drawn up front, then the rounds are independent */
+        std::vector<pIntClass> a(witnesses > 0 ? witnesses : 0);
+        for (auto& w : a) {
+            w = Rands.Rand();
+            w += 2;
         }
 
-        for (size_t ix = 0; ix < witnesses; ix++)
-        {
-            pIntClass a = Rands.Rand();
-            a += 2;
-
-            //std::cout << "a: " << a.ToString() << std::endl;
-            pIntClass x = modpow(a, d, m);
-
-            for (int i = 0; i < s; i++) {
-               pIntClass y = modmult(x, x, m);
-               pIntClass t = m;
-               t -= x;
-               if (y.IsOne() && !x.IsOne() && !t.IsOne() ) {
-                   std::cout << "mr fail at " << ix << " ";
-                    return false;  
-                }
-                x = y;
-            }
-            if (!x.IsOne()) {
-                std::cout << "mr fail at " << ix << " ";
-                return false;
-            }
+        /* every thread takes the next round until the witnesses run out or one proves m composite */
+        std::atomic<int> next(0);
+        std::atomic<int> failed(-1);
+        auto rounds = [&]() {
+            for (int ix = next++; ix < witnesses && failed < 0; ix = next++)
+                if (!StrongProbablePrime(ctx, d, s, a[ix])) failed = ix;
+        };
+        /* more threads than cores only put more rounds in flight when m is composite */
+        int cores = (int)std::thread::hardware_concurrency();
+        if (cores > 0) threads = std::min(threads, cores);
+        std::vector<std::thread> workers;
+        if (threads > 1 && m.Size() >= MRTHREADLIMIT)
+            for (int t = 1; t < std::min(threads, witnesses); t++) workers.emplace_back(rounds);
+        rounds();
+        for (auto& w : workers) w.join();
+
+        if (failed >= 0) {
+            std::cout << "mr fail at " << failed << " ";
+            return false;
         }
     }
     return true;
 }
 
+/*
+*   Baillie-PSW: a strong probable prime test to base 2 and a strong Lucas test with Selfridge's
+*   parameters (the first D in 5, -7, 9, -11, ... with (D / n) = -1, P = 1, Q = (1 - D) / 4).
+*   No composite passing both is known, and none exists below 2^64; below 2^64 the answer comes
+*   from the bases 2, 3, .., 37 instead, which are deterministic there.
+*   The Lucas sequences are computed in Montgomery form, halving is x / 2 = (x + n) / 2 for odd x.
+*/
+
+/* (a + b) mod n, (a - b) mod n and a / 2 mod n for 0 <= a, b < n */
+static void AddMod(pIntClass& a, const pIntClass& b, const pIntClass& n)
+{
+	a += b;
+	if (!(a < n)) a -= n;
+}
+
+static void SubMod(pIntClass& a, const pIntClass& b, const pIntClass& n)
+{
+	a -= b;
+	if (a.IsNeg()) a += n;
+}
+
+static void HalfMod(pIntClass& a, const pIntClass& n)
+{
+	if (a[0] & 1) a += n;
+	a.DivModInt(2);
+}
+
+/* n + 1 = d * 2^s, strong Lucas probable prime for P = 1, Q = (1 - D) / 4 */
+static bool StrongLucasProbablePrime(const MontgomeryContext& ctx, int D)
+{
+	const pIntClass& n = ctx.Modulus();
+	pIntClass d = n;
+	d += 1;
+	unsigned int s = d.TrailingZeroBits();
+	d >>= s;
+
+	std::vector<uint32_t> bits;
+	for (pIntClass t = d; !t.IsZero(); ) bits.push_back(t.DivModInt(2));
+
+	/* U_1 = 1, V_1 = P = 1, Q^1 */
+	pIntClass U = ctx.One();
+	pIntClass V = ctx.One();
+	pIntClass Q = ctx.ToMontgomery(pIntClass((1 - D) / 4));
+	pIntClass Qk = Q;
+	for (size_t i = bits.size() - 1; i > 0; i--) {
+		/* U_2k = U_k V_k,  V_2k = V_k^2 - 2 Q^k */
+		U = ctx.Multiply(U, V);
+		V = ctx.Square(V);
+		SubMod(V, Qk, n);
+		SubMod(V, Qk, n);
+		Qk = ctx.Square(Qk);
+		if (bits[i - 1]) {
+			/* U_k+1 = (U_k + V_k) / 2,  V_k+1 = (D U_k + V_k) / 2 */
+			pIntClass DU = RemQuotient(U * D, n, NULL);
+			AddMod(U, V, n);
+			HalfMod(U, n);
+			AddMod(V, DU, n);
+			HalfMod(V, n);
+			Qk = ctx.Multiply(Qk, Q);
+		}
+	}
+
+	if (U.IsZero() || V.IsZero()) return true;
+	for (unsigned int r = 1; r < s; r++) {
+		V = ctx.Square(V);
+		SubMod(V, Qk, n);
+		SubMod(V, Qk, n);
+		if (V.IsZero()) return true;
+		Qk = ctx.Square(Qk);
+	}
+	return false;
+}
+
+/* 0 <= n < 2^64 = 18 446744073 709551616, compared by limbs: a static pIntClass would keep limbs from the first caller's memory resource */
+static bool BelowTwoTo64(const pIntClass& n)
+{
+	static const int limbs[3] = { 709551616, 446744073, 18 };
+	pIntClass t = n;
+	if (t.Size() != 3) return t.Size() < 3;
+	for (int i = 2; i >= 0; i--)
+		if (t[i] != limbs[i]) return t[i] < limbs[i];
+	return false;
+}
+
+bool BailliePSW(const pIntClass& number)
+{
+	static const int bases[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+
+	if (number.IsNeg() || number.IsZero() || number.IsOne()) return false;
+	uint32_t factor;
+	if (HasSmallFactor(number, TRIALDIVISIONBOUND, &factor))
+		return number == pIntClass((int)factor);
+
+	MontgomeryContext ctx(number);
+	pIntClass d = number;
+	d -= 1;
+	unsigned int s = d.TrailingZeroBits();
+	d >>= s;
+
+	if (BelowTwoTo64(number)) {
+		for (int a : bases)
+			if (!StrongProbablePrime(ctx, d, s, pIntClass(a))) return false;
+		return true;
+	}
+
+	if (!StrongProbablePrime(ctx, d, s, pIntClass(2))) return false;
+
+	/* no D with (D / n) = -1 exists for squares */
+	if (IsPerfectSquare(number)) return false;
+	int D = 5;
+	for (;;) {
+		int j = Jacobi(pIntClass(D), number);
+		if (j == -1) break;
+		if (j == 0) return false;       // |D| < n shares a factor with n
+		D = (D > 0) ? -(D + 2) : -D + 2;
+	}
+	return StrongLucasProbablePrime(ctx, D);
+}
+
+size_t FilterPrimes(const pIntClass* candidates, size_t count, const std::function<bool(size_t, const pIntClass&)>& found, int threads)
+{
+	if (threads < 1) threads = 1;
+
+	size_t reported = 0;
+	std::vector<char> prime(FILTERBATCH * threads);
+	for (size_t from = 0; from < count; from += prime.size()) {
+		size_t n = std::min(prime.size(), count - from);
+
+		/* the threads take the candidates of the batch one at a time */
+		std::atomic<size_t> next(0);
+		auto test = [&]() {
+			for (size_t i = next++; i < n; i = next++) prime[i] = BailliePSW(candidates[from + i]);
+		};
+		std::vector<std::thread> workers;
+		for (int t = 1; t < threads && (size_t)t < n; t++) workers.emplace_back(test);
+		test();
+		for (auto& w : workers) w.join();
+
+		for (size_t i = 0; i < n; i++)
+			if (prime[i]) {
+				reported++;
+				if (!found(from + i, candidates[from + i])) return reported;
+			}
+	}
+	return reported;
+}
+
+std::vector<pIntClass> FilterPrimes(const pIntClass* candidates, size_t count, int threads)
+{
+	std::vector<pIntClass> primes;
+	FilterPrimes(candidates, count, [&](size_t, const pIntClass& p) { primes.push_back(p); return true; }, threads);
+	return primes;
+}
+
 
 bool  CheckedTonelliShanks(const pIntClass& n, const pIntClass& p, pIntClass& res) {
 
@@ -472,3 +935,260 @@ bool  CheckedTonelliShanks(const pIntClass& n, const pIntClass& p, pIntClass& re
 }
 
 
+/* (a / n) for odd n > 0 with subtractions and shifts only */
+static int BinaryJacobi(const pIntClass& a, const pIntClass& n)
+{
+	pIntClass A = a;
+	pIntClass N = n;
+	pIntClass* x = &A;
+	pIntClass* y = &N;
+	int result = 1;
+	if (x->IsNeg()) {
+		x->ChSignBit();
+		if ((N[0] & 3) == 3) result = -result;     // (-1 / n)
+	}
+
+	while (!x->IsZero()) {
+		unsigned int k = x->TrailingZeroBits();
+		if (k) {
+			*x >>= k;
+			if ((k & 1) && Jacobi2((*y)[0]) < 0) result = -result;
+		}
+		if (*x < *y) {
+			std::swap(x, y);
+			result *= Reciprocity((*x)[0], (*y)[0]);
+		}
+		*x -= *y;
+	}
+	return y->IsOne() ? result : 0;
+}
+
+/* (a / b), b odd, |b| is used for b < 0 */
+int Jacobi(const pIntClass& a, const pIntClass& b)
+{
+	pIntClass n = b;
+	if (n.IsNeg()) n.ChSignBit();
+	if (n.IsZero())
+		return 1;
+	if ((n[0] & 1) == 0) {
+		std::cout << "Jacobi: the modulus must be odd" << std::endl;
+		return 0;
+	}
+	if (n.Size() < JACOBILIMIT && a.Size() < JACOBILIMIT)
+		return BinaryJacobi(a, n);
+
+	/* Lehmer steps on (n, a mod n), the quotients update the symbol */
+	pIntClass x = n;
+	pIntClass y = RemQuotient(a, n, NULL);
+	JacobiState J = { x[0] & 7, y[0] & 7, 0, 1 };
+	while (!y.IsZero())
+		if (!LehmerStep(x, y, NULL, &J)) DivisionStep(x, y, NULL, &J);
+	return x.IsOne() ? J.sign : 0;
+}
+
+/*
+*   Integer roots.  floor(n^(1/k)) is computed from the root of the leading limbs:
+*   with T = n / B^(ks) and r = floor(T^(1/k)), x = r * B^s is below the root by less than
+*   about 1.5 B^s and one Newton step  x = ((k - 1) x + n / x^(k-1)) / k  squares that error
+*   relative to the root, so for  2s < (N - 1) / k - 1  (N limbs in n) it lands on the
+*   root or one above. The work is dominated by the last division and power.
+*/
+
+/* x^k */
+static pIntClass Power(const pIntClass& x, int k)
+{
+	pIntClass result(1);
+	pIntClass p = x;
+	while (k) {
+		if (k & 1) result *= p;
+		k >>= 1;
+		if (k) p *= p;
+	}
+	return result;
+}
+
+/* one Newton step for the k'th root of n from x > 0, the result is >= floor(n^(1/k)) */
+static pIntClass RootNewtonStep(const pIntClass& n, const pIntClass& x, int k)
+{
+	pIntClass q;
+	RemQuotient(n, Power(x, k - 1), &q);
+	q.AddMul(x, k - 1);
+	q.DivModInt((uint32_t)k);
+	return q;
+}
+
+/* floor(n^(1/k)), n >= 0, k >= 2 */
+static pIntClass RootFloor(const pIntClass& n, int k)
+{
+	int N = n.Size();
+	if (N == 0) return n;
+	int s = ((N - 1) / k - 1) / 2;
+
+	if (s < 1) {
+		/* decreasing Newton iteration from a floating point estimate a little above the root */
+		pIntClass t = n;
+		double lead = (double)t[N - 1] + ((N > 1) ? t[N - 2] / (double)pIntClass::MODULUS : 0.0);
+		double f = (std::log10(lead) + 9.0 * (N - 1)) / k;
+		double digits = std::floor(f);
+		pIntClass x;
+		if (digits < 8) {
+			x = (int)std::ceil(std::pow(10.0, f) * (1 + 1e-9)) + 1;
+		}
+		else {
+			x = (int)std::ceil(std::pow(10.0, f - digits + 8) * (1 + 1e-9));
+			x += 1;
+			x.MulPow10((unsigned int)digits - 8);
+		}
+		for (;;) {
+			pIntClass y = RootNewtonStep(n, x, k);
+			if (!(y < x)) return x;
+			x = y;
+		}
+	}
+
+	pIntClass T = n;
+	T.ShiftLimbsRight((unsigned int)(k * s));
+	pIntClass x = RootFloor(T, k);
+	x.ShiftLimbsLeft((unsigned int)s);
+	x = RootNewtonStep(n, x, k);
+	while (n < Power(x, k)) --x;
+	return x;
+}
+
+pIntClass ISqrt(const pIntClass& n)
+{
+	return IRoot(n, 2);
+}
+
+pIntClass IRoot(const pIntClass& n, int k)
+{
+	if (k < 1) {
+		std::cout << "IRoot: the exponent must be positive" << std::endl;
+		return pIntClass();
+	}
+	if (k == 1) return n;
+	if (n.IsNeg()) {
+		if ((k & 1) == 0) {
+			std::cout << "IRoot: even root of a negative number" << std::endl;
+			return pIntClass();
+		}
+		pIntClass m = n;
+		m.ChSignBit();
+		pIntClass r = RootFloor(m, k);
+		r.ChSignBit();
+		return r;
+	}
+	return RootFloor(n, k);
+}
+
+/*
+*   Squares mod 512 (n mod 512 is the low limb mod 512 as 512 divides 10^9), 63, 65, 11 and 17, 19, 23, 31:
+*   a non-square passes all of them with probability below 1 / 1000.
+*/
+static const uint32_t SquareModuli[] = { 63, 65, 11, 17, 19, 23, 31 };
+#define SQUAREMODULI (sizeof(SquareModuli) / sizeof(SquareModuli[0]))
+
+struct SquareTables {
+	bool tables[SQUAREMODULI + 1][512] = {};
+	pIntDivisor divisors[SQUAREMODULI];
+
+	SquareTables() {
+		for (uint32_t i = 0; i < 512; i++) tables[0][(i * i) % 512] = true;
+		for (size_t j = 0; j < SQUAREMODULI; j++) {
+			for (uint32_t i = 0; i < SquareModuli[j]; i++) tables[j + 1][(i * i) % SquareModuli[j]] = true;
+			divisors[j] = pIntDivisor(SquareModuli[j]);
+		}
+	}
+};
+
+bool IsPerfectSquare(const pIntClass& n, pIntClass* root)
+{
+	/* filled once by the constructor, thread safe */
+	static const SquareTables squares;
+	const auto& tables = squares.tables;
+	const pIntDivisor* divisors = squares.divisors;
+
+	if (n.IsNeg()) return false;
+	if (!n.IsZero()) {
+		pIntClass t = n;
+		if (!tables[0][t[0] & 511]) return false;
+		uint32_t remainders[SQUAREMODULI];
+		n.ModInts(divisors, SQUAREMODULI, remainders);
+		for (size_t j = 0; j < SQUAREMODULI; j++)
+			if (!tables[j + 1][remainders[j]]) return false;
+	}
+
+	pIntClass r = RootFloor(n, 2);
+	if (r * r != n) return false;
+	if (root) *root = r;
+	return true;
+}
+
+/* x^e mod q, q < 2^32 */
+static u64 PowModWord(u64 x, u64 e, u64 q)
+{
+	u64 result = 1;
+	x %= q;
+	while (e) {
+		if (e & 1) result = (result * x) % q;
+		x = (x * x) % q;
+		e >>= 1;
+	}
+	return result;
+}
+
+static bool IsSmallPrime(u64 q)
+{
+	if (q < 2) return false;
+	for (u64 d = 2; d * d <= q; d++)
+		if (q % d == 0) return false;
+	return true;
+}
+
+bool IsPerfectPower(const pIntClass& n, pIntClass* base, int* exponent)
+{
+	if (n.IsNeg() || n.IsZero() || n.IsOne()) return false;
+
+	/* n = r^k, r >= 2 needs k <= log2(n), it is enough to try prime k */
+	pIntClass t = n;
+	int N = t.Size();
+	double lead = (double)t[N - 1] + ((N > 1) ? t[N - 2] / (double)pIntClass::MODULUS : 0.0);
+	int maxk = (int)((std::log10(lead) + 9.0 * (N - 1)) * 3.3219280948873623) + 1;
+
+	for (int k = 2; k <= maxk; k++) {
+		if (!IsSmallPrime(k)) continue;
+
+		pIntClass r;
+		if (k == 2) {
+			if (!IsPerfectSquare(n, &r)) continue;
+		}
+		else {
+			/* a k'th power is 0 or a k'th power residue mod primes q = 1 mod k, others pass with chance 1 / k */
+			bool residue = true;
+			int tried = 0;
+			for (u64 q = 2 * (u64)k + 1; tried < 3 && q < 0xFFFFFFFFu && residue; q += 2 * (u64)k) {
+				if (!IsSmallPrime(q)) continue;
+				tried++;
+				u64 a = n.ModInt((uint32_t)q);
+				residue = (a == 0) || (PowModWord(a, (q - 1) / k, q) == 1);
+			}
+			if (!residue) continue;
+			r = RootFloor(n, k);
+			if (Power(r, k) != n) continue;
+		}
+
+		/* the largest exponent comes from the root */
+		int e = k;
+		pIntClass b = r;
+		int e2;
+		pIntClass b2;
+		if (IsPerfectPower(r, &b2, &e2)) {
+			b = b2;
+			e *= e2;
+		}
+		if (base) *base = b;
+		if (exponent) *exponent = e;
+		return true;
+	}
+	return false;
+}
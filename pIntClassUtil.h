@@ -8,6 +8,8 @@ You should have received a copy of the GNU General Public License along with thi
 This General Public License does not permit incorporating your program into proprietary programs.If your program is a subroutine library, you may consider it more useful to permit linking proprietary applications with the library.
 If this is what you want to do, use the GNU Library General Public License instead of this License.
 */
+#include <functional>
+#include <vector>
 #include "pIntClass.h"
 
 pIntClass modmult(const pIntClass& _a, const pIntClass& _b, const pIntClass& mod);
@@ -16,6 +18,52 @@ pIntClass modpow(const pIntClass& _a, const pIntClass& _b, const pIntClass& mod)
 
 pIntClass exponentiation(int  a, int exp);
 
-bool MillerRabin(const pIntClass& number,  int witnesses);
+/* gcd(|a|, |b|), the extended version also returns x, y with a * x + b * y = gcd (either may be NULL) */
+pIntClass Gcd(const pIntClass& a, const pIntClass& b);
+pIntClass ExtendedGcd(const pIntClass& a, const pIntClass& b, pIntClass* x, pIntClass* y);
+/* inv = 1 / a mod |m| in [0, |m|[, false if gcd(a, m) != 1 */
+bool ModInverse(const pIntClass& a, const pIntClass& m, pIntClass& inv);
+/*
+*   inverses[i] = 1 / values[i] mod |m| for all i with one ModInverse and 3 (count - 1) modular
+*   multiplications (Montgomery's trick), split in chunks over up to 'threads' threads.
+*   false if some value has no inverse, its entry is then 0 and the others are still set.
+*   With threads > 1 the memory resource of inverses[] must be thread safe.
+*/
+bool BatchModInverse(const pIntClass* values, size_t count, const pIntClass& m, pIntClass* inverses, int threads = 1);
+
+/* floor(sqrt(n)), floor(n^(1/k)) (rounded toward 0 for n < 0 and odd k) */
+pIntClass ISqrt(const pIntClass& n);
+pIntClass IRoot(const pIntClass& n, int k);
+/* n = root^2,  n = base^exponent with the largest exponent >= 2 */
+bool IsPerfectSquare(const pIntClass& n, pIntClass* root = NULL);
+bool IsPerfectPower(const pIntClass& n, pIntClass* base = NULL, int* exponent = NULL);
+
+/*
+*   true if |n| has a prime factor p <= bound (returned in factor), found with remainders modulo
+*   products of small primes (one ModInts pass), bounds above SMALLFACTORLIMIT are lowered to it.  MillerRabin rejects odd numbers with a factor
+*   up to trialbound first: with the default about 85% of random odd candidates.
+*   From MRTHREADLIMIT limbs MillerRabin runs the witnesses on up to 'threads' threads,
+*   they all stop after their current round when one witness proves the number composite.
+*/
+#define TRIALDIVISIONBOUND 4096
+#define SMALLFACTORLIMIT 65536
+#define MRTHREADLIMIT 16
+bool HasSmallFactor(const pIntClass& n, uint32_t bound, uint32_t* factor = NULL);
+
+bool MillerRabin(const pIntClass& number,  int witnesses, uint32_t trialbound = TRIALDIVISIONBOUND, int threads = 1);
+/* Baillie-PSW probable prime test, deterministic below 2^64 */
+bool BailliePSW(const pIntClass& number);
+
+/*
+*   The probable primes (BailliePSW) among candidates[0 .. count - 1], in order.  The candidates
+*   are tested in batches of FILTERBATCH per thread on up to 'threads' threads; in BailliePSW a
+*   composite almost always stops at the trial division (one ModInts pass) or the base 2 test.
+*   The callback variant calls found(index, candidate) for the survivors after each batch and
+*   stops when it returns false, it returns the number of calls.
+*   The tables shared by the workers (small primes, square residues) are built once, thread safe.
+*/
+#define FILTERBATCH 64
+std::vector<pIntClass> FilterPrimes(const pIntClass* candidates, size_t count, int threads = 1);
+size_t FilterPrimes(const pIntClass* candidates, size_t count, const std::function<bool(size_t, const pIntClass&)>& found, int threads = 1);
 
 bool  TonelliShanks(const pIntClass& n, const pIntClass& p, pIntClass& res);